@@ -19,10 +19,35 @@ DESCRIPTION: This program implements the greedy algorithm of Kempe, Kleinberg, a
 #include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <iomanip>
 #include <chrono>
 #include <set>
 #include <queue>
 #include <map>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <numeric>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <climits>
+#include <condition_variable>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <linux/perf_event.h>
+#include <cstring>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <cerrno>
 
 using namespace std;
 
@@ -33,43 +58,8482 @@ using namespace std;
 const char POUND = '#';
 const char PERCENT = '%';
 
+// Constant ints naming the edgelist formats the program reads
+const int FORMAT_AUTO = 0;
+const int FORMAT_SNAP = 1;
+const int FORMAT_KONECT = 2;
+const int FORMAT_MATRIX_MARKET = 3;
+
+// Constant int for user to specify the format of the cascade files
+// (FORMAT_AUTO detects it from the first line of each file), and constant
+// bool for whether the ids of formats counting from 1 (KONECT, Matrix Market)
+// are shifted to count from 0
+const int PARAM_INPUT_FORMAT = FORMAT_AUTO;
+const bool PARAM_ZERO_BASED_IDS = false;
+
 // Constant int for user to specify number of influential nodes desired
 const int PARAM_K = 1;
 
-// Constant string for user to specify directory of cascade files
-const string CASCADE_DIRECTORY = "/path/to/cascades/";
+// Constant string for user to specify directory of cascade files
+const string CASCADE_DIRECTORY = "/path/to/cascades/";
+
+// Constant ints naming the modes the program can run in
+const int MODE_GREEDY = 0;
+const int MODE_TOPICS = 1;
+const int MODE_STREAMING = 2;
+const int MODE_SUBSAMPLE = 3;
+const int MODE_RACING = 4;
+const int MODE_SCREENING = 5;
+const int MODE_CORESET = 6;
+const int MODE_LAZY = 7;
+const int MODE_BENCHMARK = 8;
+const int MODE_PREFETCH = 9;
+const int MODE_BACKENDS = 10;
+const int MODE_VERIFY = 11;
+const int MODE_SCALING = 12;
+const int MODE_ROBUST = 13;
+const int MODE_REACHABILITY = 14;
+const int MODE_BITSET = 15;
+
+// Constant int for user to specify the mode the program runs in
+const int PARAM_MODE = MODE_GREEDY;
+
+// Constant string for user to specify the file listing the topics (subsets of
+// the cascade files) used in MODE_TOPICS
+const string TOPIC_FILE = "/path/to/topics.txt";
+
+// Constant int for user to specify the seed of the random number generator
+// used by the randomized modes
+const int PARAM_RANDOM_SEED = 1;
+
+// Constant bool for user to specify whether runs print byte-identical output
+// for the same input and seed whatever the number of threads (MODE_LAZY then
+// re-evaluates batches whose size does not depend on the number of threads,
+// and timings and per-thread counters are left out)
+const bool PARAM_REPRODUCIBLE = false;
+
+// Constant string for user to specify the file, named pipe, or /dev/stdin that
+// MODE_STREAMING reads cascades from (separated by empty lines), constant bool
+// for whether the other modes also read their cascades from it instead of
+// from CASCADE_DIRECTORY, and constant int for the input (in KB) the reader
+// buffers
+const string STREAM_PATH = "/dev/stdin";
+const bool PARAM_LOAD_STREAM = false;
+const int PARAM_READ_BUFFER_KB = 64;
+
+// Constant bool for user to specify whether MODE_STREAMING keeps waiting for a
+// growing file, and constant int for the seconds without new input after
+// which it stops waiting
+const bool PARAM_STREAM_FOLLOW = false;
+const int PARAM_STREAM_IDLE_SEC = 10;
+
+// Constant ints for user to specify the number of cascades MODE_STREAMING
+// keeps in memory to estimate influence, and how often it prints the current set
+const int PARAM_STREAM_RESERVOIR = 1000;
+const int PARAM_STREAM_REPORT = 1000;
+
+// Constant double for user to specify the epsilon of the sieve thresholds in
+// MODE_STREAMING
+const double PARAM_STREAM_EPSILON = 0.1;
+
+// Constant double for user to specify the probability with which the
+// statistical modes must make the same choice as the exact greedy algorithm
+const double PARAM_CONFIDENCE = 0.95;
+
+// Constant int for user to specify the number of cascades MODE_SUBSAMPLE
+// starts each iteration with
+const int PARAM_SUBSAMPLE_INITIAL = 64;
+
+// Constant int for user to specify the number of cascades MODE_RACING
+// processes between eliminations, and constant bool for whether it eliminates
+// only candidates that provably cannot win (exact) or uses confidence intervals
+const int PARAM_RACE_BLOCK = 256;
+const bool PARAM_RACE_EXACT = true;
+
+// Constant int for user to specify the size of the reachability sketches used
+// by MODE_SCREENING, and constant double for the number of standard errors
+// its sketch estimates are trusted to be within when picking the shortlist
+const int PARAM_SKETCH_K = 64;
+const double PARAM_SCREEN_Z = 3.0;
+
+// Constant string for user to specify the directory MODE_CORESET writes the
+// coreset to, constant int for the number of cascades it draws (0 derives it
+// from the epsilon), and constant double for the relative error it targets
+const string CORESET_DIRECTORY = "/path/to/coreset/";
+const int PARAM_CORESET_SIZE = 0;
+const double PARAM_CORESET_EPSILON = 0.1;
+
+// Constant int for user to specify the number of worker threads (0 uses all
+// hardware threads)
+const int PARAM_THREADS = 0;
+
+// Constant bool for user to specify whether the cascade directory is loaded by
+// a pipeline of concurrent stages (reading, parsing, indexing, statistics),
+// constant int for the number of parsing threads of the pipeline, and constant
+// int for the number of cascades each queue between two stages holds
+const bool PARAM_PIPELINED_LOAD = false;
+const int PARAM_PIPELINE_PARSERS = 2;
+const int PARAM_PIPELINE_DEPTH = 64;
+
+// Constant int for user to specify how many stale queue entries per thread
+// MODE_LAZY re-evaluates at once
+const int PARAM_LAZY_BATCH = 4;
+
+// Constant int for user to specify the memory (in MB) of the cache of reach
+// lists used by MODE_LAZY (0 disables the cache)
+const int PARAM_CACHE_MB = 256;
+
+// Constant bool for user to specify whether MODE_LAZY speculatively evaluates
+// the next iteration's gains assuming the current leader wins
+const bool PARAM_SPECULATE = true;
+
+// Constant bool for user to specify whether the worker threads are pinned to
+// CPUs (spread round-robin over the NUMA nodes), and constant bool for whether
+// MODE_LAZY places each worker's share of the cascades on its own NUMA node
+// (otherwise the cascades are interleaved over all nodes)
+const bool PARAM_PIN_THREADS = false;
+const bool PARAM_NUMA_LOCAL = true;
+
+// Constant ints naming how the large flat arrays are backed: by ordinary
+// pages, by transparent huge pages, or by reserved huge pages (hugetlbfs,
+// falling back to transparent huge pages when none are free)
+const int HUGE_PAGES_OFF = 0;
+const int HUGE_PAGES_TRANSPARENT = 1;
+const int HUGE_PAGES_RESERVED = 2;
+
+// Constant int for user to specify how the large flat arrays are backed
+const int PARAM_HUGE_PAGES = HUGE_PAGES_TRANSPARENT;
+
+// Size of a huge page; flat arrays smaller than this use ordinary memory
+const size_t HUGE_PAGE_BYTES = 2 << 20;
+
+// How the flat arrays allocated from now on are backed; starts as
+// PARAM_HUGE_PAGES and is switched by MODE_BENCHMARK
+int use_huge_pages = PARAM_HUGE_PAGES;
+
+// Constant int for user to specify how many queue entries ahead breadth-first
+// searches prefetch (0 disables prefetching; MODE_PREFETCH shows which
+// distance pays off on a machine), and constant int for how many times the
+// last level cache the larger cascade of MODE_PREFETCH is
+const int PARAM_PREFETCH_DISTANCE = 0;
+const int PARAM_PREFETCH_ABOVE_LLC = 4;
+
+// Prefetch distance used by the searches; starts as PARAM_PREFETCH_DISTANCE
+// and is switched by MODE_PREFETCH
+int prefetch_distance = PARAM_PREFETCH_DISTANCE;
+
+// Constant int for user to specify how many random seed sets MODE_BACKENDS
+// evaluates, and constant string for the file it writes the mapped backend to
+const int PARAM_BACKEND_QUERIES = 100;
+const string STORE_FILE = "/tmp/cascade_store.bin";
+
+// Constant int for user to specify how many random corpora MODE_VERIFY checks
+// the engines on, and constant int for the size of the seed sets it selects
+const int PARAM_VERIFY_CORPORA = 20;
+const int PARAM_VERIFY_K = 5;
+
+// Constant ints naming the kinds of random corpora generate_cascades makes;
+// MODE_VERIFY rotates through them
+const int CORPUS_FORESTS = 0;
+const int CORPUS_ACYCLIC = 1;
+const int CORPUS_CYCLIC = 2;
+
+// Constant string for user to specify the directory MODE_SCALING writes its
+// generated cascades to and the CSV file it writes its results to, constant
+// int for the most threads it uses (0 uses all hardware threads), constant
+// ints for the number of cascades of its smallest corpus (and per thread in
+// the weak scaling study) and for how many corpus sizes (each four times the
+// last) the strong scaling study uses, and constant int for the largest
+// generated cascade
+const string SCALING_DIRECTORY = "/tmp/scaling_cascades/";
+const string SCALING_FILE = "scaling.csv";
+const int PARAM_SCALING_MAX_THREADS = 0;
+const int PARAM_SCALING_CASCADES = 2000;
+const int PARAM_SCALING_SIZES = 3;
+const int PARAM_SCALING_MAX_SIZE = 50;
+
+// Constant int for user to specify how many runners-up (the candidates with
+// the next largest gains) the run report lists for every iteration
+const int PARAM_RUNNERS_UP = 3;
+
+// Constant string for user to specify the CSV file the table of each seed's
+// exclusive reach per cascade is written to after the greedy algorithm (empty
+// for no table)
+const string ATTRIBUTION_FILE = "";
+
+// Constant string for user to specify the file the influence curve is written
+// to after the greedy algorithm: the node chosen in each iteration, its
+// marginal gain and the influence of the set so far. A name ending in .json
+// gives JSON, any other name CSV (empty for no curve)
+const string CURVE_FILE = "";
+
+// Constant vector of strings for user to specify the cascade directories (one
+// per corpus) MODE_ROBUST selects seeds for, constant int for the number of
+// steps of its binary search, and constant double for how many times PARAM_K
+// seeds it may use (alpha of the SATURATE algorithm)
+const vector<string> ROBUST_DIRECTORIES = {"/path/to/corpus_1/", "/path/to/corpus_2/"};
+const int PARAM_ROBUST_STEPS = 20;
+const double PARAM_ROBUST_ALPHA = 1.0;
+
+// Constant string for user to specify the file of queries MODE_REACHABILITY
+// answers, one pair of nodes "u v" per line, and constant int for the number
+// of interval labels per slot its reachability index keeps
+const string QUERY_FILE = "/path/to/queries.txt";
+const int PARAM_REACH_LABELS = 2;
+
+// Constant int for user to specify the largest cascade (in nodes) MODE_BITSET
+// keeps reach bitsets for; larger cascades are searched instead
+const int PARAM_BITSET_MAX_SLOTS = 4096;
+
+// Constant bool for user to specify whether allocations are counted by phase
+// and reported (MODE_LAZY and MODE_BENCHMARK also report them per iteration)
+const bool PARAM_TRACK_ALLOCATIONS = false;
+
+// Constant int for user to specify how many times MODE_BENCHMARK,
+// MODE_PREFETCH and MODE_SCALING run each configuration
+const int PARAM_BENCHMARK_REPEATS = 3;
+
+
+
+
+
+/*
+Structure: AllocationTag
+Description: Counters of the allocations made while one phase of the program
+			 (a tag, see AllocationScope) was current on the allocating
+			 thread, kept when PARAM_TRACK_ALLOCATIONS is set. Frees count
+			 toward the phase the freeing thread is in. Flat arrays of at least
+			 HUGE_PAGE_BYTES are mapped directly (see allocate_flat) and are
+			 not counted.
+*/
+struct AllocationTag
+{
+	const char* name = NULL;
+	atomic<long long> allocations{0};
+	atomic<long long> bytes{0};
+	atomic<long long> frees{0};
+};
+
+const int MAX_ALLOCATION_TAGS = 64;
+
+// the tags registered so far (tag 0 counts allocations outside any phase),
+// and the tag of the phase the calling thread is in
+AllocationTag allocation_tags[MAX_ALLOCATION_TAGS];
+atomic<int> num_allocation_tags{1};
+thread_local int current_allocation_tag = 0;
+
+
+
+
+/*
+Function: operator new, operator delete
+Description: Replace the global allocation functions so that, with
+			 PARAM_TRACK_ALLOCATIONS set, every allocation and free is
+			 counted toward the current phase. Memory comes from malloc either
+			 way.
+*/
+// kept out of line: when they are inlined, GCC pairs malloc and free with the
+// standard operators around them and warns (-Wmismatched-new-delete)
+__attribute__((noinline)) void* operator new(size_t bytes)
+{
+
+	if (PARAM_TRACK_ALLOCATIONS) {
+		AllocationTag& tag = allocation_tags[current_allocation_tag];
+		tag.allocations.fetch_add(1, memory_order_relaxed);
+		tag.bytes.fetch_add(bytes, memory_order_relaxed);
+	}
+
+	void* p = malloc(bytes == 0 ? 1 : bytes);
+
+	if (p == NULL) {
+		throw bad_alloc();
+	}
+
+	return p;
+
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+
+	if (PARAM_TRACK_ALLOCATIONS && p != NULL) {
+		allocation_tags[current_allocation_tag].frees.fetch_add(1, memory_order_relaxed);
+	}
+
+	free(p);
+
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	operator delete(p);
+}
+
+
+
+
+/*
+Function: allocation_tag
+Input: pointer to chars
+Output: int
+
+Description: Returns the tag of the phase with the given name, registering it
+the first time. Meant to be called once per call site and kept in a static,
+e.g. static int tag = allocation_tag("LOAD").
+*/
+int allocation_tag(const char* name)
+{
+
+	static mutex lock;
+	lock_guard<mutex> guard(lock);
+
+	int n = num_allocation_tags.load();
+	for (int t = 1; t < n; t++) {
+		if (strcmp(allocation_tags[t].name, name) == 0) {
+			return t;
+		}
+	}
+
+	if (n == MAX_ALLOCATION_TAGS) {
+		return 0;
+	}
+
+	allocation_tags[n].name = name;
+	num_allocation_tags.store(n + 1);
+
+	return n;
+
+}
+
+
+
+
+/*
+Structure: AllocationScope
+Description: Makes a tag the current phase of the calling thread for the
+			 lifetime of the scope and restores the previous phase at its
+			 end. Each thread has its own phase: the workers of the thread
+			 pool take on the phase of the thread that started the job (see
+			 ThreadPool::run), so scopes can be opened on any thread.
+*/
+struct AllocationScope
+{
+
+	int previous = 0;
+
+	AllocationScope(int tag)
+	{
+		if (PARAM_TRACK_ALLOCATIONS) {
+			previous = current_allocation_tag;
+			current_allocation_tag = tag;
+		}
+	}
+
+	~AllocationScope()
+	{
+		if (PARAM_TRACK_ALLOCATIONS) {
+			current_allocation_tag = previous;
+		}
+	}
+
+};
+
+
+
+
+/*
+Function: allocation_count
+Input: none
+Output: long long
+
+Description: Returns the number of allocations counted so far in all phases.
+*/
+long long allocation_count()
+{
+
+	long long count = 0;
+
+	for (int t = 0; t < num_allocation_tags.load(); t++) {
+		count += allocation_tags[t].allocations.load(memory_order_relaxed);
+	}
+
+	return count;
+
+}
+
+
+
+
+/*
+Function: print_allocations
+Input: none
+Output: none
+
+Description: Prints the allocations, allocated bytes and frees counted in
+every phase, if PARAM_TRACK_ALLOCATIONS is set. Runs when the program ends.
+*/
+void print_allocations()
+{
+
+	if (!PARAM_TRACK_ALLOCATIONS) {
+		return;
+	}
+
+	cout << endl << "ALLOCATIONS BY PHASE:" << endl;
+
+	for (int t = 0; t < num_allocation_tags.load(); t++) {
+
+		AllocationTag& tag = allocation_tags[t];
+
+		if (tag.allocations.load() == 0 && tag.frees.load() == 0) {
+			continue;
+		}
+
+		cout << (t == 0 ? "OTHER" : tag.name) << ": " << to_string(tag.allocations.load()) << " ALLOCATIONS ("
+			<< to_string(tag.bytes.load()) << " BYTES), " << to_string(tag.frees.load()) << " FREES" << endl;
+
+	}
+
+}
+
+
+
+
+/*
+Function: print_set
+Input: Set of integers
+Output: None
+
+Description: Helper function that prints a set of integers to the console.
+*/
+void print_set(set<int>& S)
+{
+
+	cout << "{";
+
+	int count = 0;
+
+	for (int s : S) {
+
+		cout << to_string(s);
+
+		count++;
+
+		if (count < S.size()) {
+			cout << ", ";
+		}
+
+	}
+
+	cout << "}";
+
+}
+
+
+
+
+/*
+Structure: IterationRanking
+Description: The candidates with the largest marginal gains in one iteration
+			 of a greedy algorithm: the chosen node first, then up to
+			 PARAM_RUNNERS_UP runners-up, in the order the algorithm ranks
+			 them. If the algorithm only knows an upper bound on the gains
+			 of the other candidates (the lazy queue), others_bound holds
+			 it; otherwise it is -1.
+*/
+struct IterationRanking
+{
+
+	// (node, marginal gain) pairs, chosen node first
+	vector<pair<int, double> > top;
+
+	double others_bound = -1;
+
+};
+
+
+
+
+/*
+Function: print_rankings
+Input: vector of iteration rankings
+Output: none
+
+Description: Prints the chosen node and the runners-up of every iteration with
+their marginal gains, and the margin by which the chosen node won.
+*/
+void print_rankings(vector<IterationRanking>& rankings)
+{
+
+	if (PARAM_RUNNERS_UP <= 0) {
+		return;
+	}
+
+	cout << endl << "RUNNERS-UP PER ITERATION (MARGINAL GAIN IN NODES):" << endl;
+
+	for (int iter = 0; iter < (int)rankings.size(); iter++) {
+
+		vector<pair<int, double> >& top = rankings[iter].top;
+
+		cout << "ITERATION " << to_string(iter + 1) << ": CHOSE " << to_string(top[0].first) << " ("
+			<< to_string(top[0].second) << ")";
+
+		for (int i = 1; i < (int)top.size(); i++) {
+			cout << (i == 1 ? "; RUNNERS-UP " : ", ") << to_string(top[i].first) << " (" << to_string(top[i].second) << ")";
+		}
+
+		if (rankings[iter].others_bound >= 0) {
+			cout << (top.size() == 1 ? "; " : ", ") << "OTHERS AT MOST " << to_string(rankings[iter].others_bound);
+		}
+
+		if (top.size() > 1) {
+			cout << "; MARGIN " << to_string(top[0].second - top[1].second);
+		}
+
+		cout << endl;
+
+	}
+
+}
+
+
+
+
+/*
+Function: write_curve
+Input: vector of iteration rankings
+Output: none
+
+Description: Writes the influence curve of a greedy run to CURVE_FILE. The
+greedy sets are nested, so the first i chosen nodes are the set the algorithm
+returns for k = i, and one run gives the influence for every budget up to k.
+Each iteration becomes one record with the node chosen, its marginal gain and
+the cumulative influence; as a JSON array of objects if the file name ends in
+.json, and as CSV rows otherwise.
+*/
+void write_curve(vector<IterationRanking>& rankings)
+{
+
+	bool json = CURVE_FILE.size() >= 5 && CURVE_FILE.compare(CURVE_FILE.size() - 5, 5, ".json") == 0;
+
+	ofstream out(CURVE_FILE.c_str());
+
+	if (json) {
+		out << "[\n";
+	}
+	else {
+		out << "size,node,marginal_gain,influence\n";
+	}
+
+	double influence = 0;
+	for (int iter = 0; iter < (int)rankings.size(); iter++) {
+
+		int node = rankings[iter].top[0].first;
+		double gain = rankings[iter].top[0].second;
+		influence += gain;
+
+		if (json) {
+			out << "  {\"size\": " << iter + 1 << ", \"node\": " << node << ", \"marginal_gain\": " << to_string(gain)
+				<< ", \"influence\": " << to_string(influence) << "}" << (iter + 1 < (int)rankings.size() ? "," : "") << "\n";
+		}
+		else {
+			out << iter + 1 << "," << node << "," << to_string(gain) << "," << to_string(influence) << "\n";
+		}
+
+	}
+
+	if (json) {
+		out << "]\n";
+	}
+
+	cout << endl << "INFLUENCE CURVE (" << to_string(rankings.size()) << " SIZES) WRITTEN TO " << CURVE_FILE << endl;
+
+}
+
+
+
+
+/*
+Structure: CounterRng
+Description: Counter-based random number generator for the randomized modes.
+			 The i-th number of the stream keyed by (seed, stream, iteration)
+			 is a fixed function of the key and i (the SplitMix64 mix of the
+			 key plus i times the golden ratio), so a draw for a given
+			 cascade in a given iteration does not depend on which draws came
+			 before it, on the number of threads, or on the standard library.
+*/
+struct CounterRng
+{
+
+	uint64_t key;
+	uint64_t counter = 0;
+
+	static uint64_t mix(uint64_t z)
+	{
+
+		z += 0x9e3779b97f4a7c15ULL;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+		return z ^ (z >> 31);
+
+	}
+
+	CounterRng(uint64_t seed, uint64_t stream, uint64_t iteration)
+	{
+		key = mix(mix(mix(seed) + stream) + iteration);
+	}
+
+	uint64_t next()
+	{
+		return mix(key + 0x9e3779b97f4a7c15ULL * counter++);
+	}
+
+	// uniform in [0, n), without modulo bias (Lemire's method)
+	uint64_t below(uint64_t n)
+	{
+
+		unsigned __int128 product = (unsigned __int128)next() * n;
+
+		if ((uint64_t)product < n) {
+			uint64_t threshold = -n % n;
+			while ((uint64_t)product < threshold) {
+				product = (unsigned __int128)next() * n;
+			}
+		}
+
+		return product >> 64;
+
+	}
+
+	// uniform in [0, 1), with 53 random bits
+	double unit()
+	{
+		return (next() >> 11) * 0x1.0p-53;
+	}
+
+};
+
+
+
+
+/*
+Function: random_order
+Input: int, int, vector of ints
+Output: none
+
+Description: Fills order with the cascades 0 to n - 1 in a random order for
+the given iteration: each cascade is sorted by its own number from the
+CounterRng keyed by (PARAM_RANDOM_SEED, cascade, iteration).
+*/
+void random_order(int n, int iteration, vector<int>& order)
+{
+
+	vector<pair<uint64_t, int> > keyed(n);
+	for (int c = 0; c < n; c++) {
+		keyed[c] = make_pair(CounterRng(PARAM_RANDOM_SEED, c, iteration).next(), c);
+	}
+	sort(keyed.begin(), keyed.end());
+
+	order.resize(n);
+	for (int i = 0; i < n; i++) {
+		order[i] = keyed[i].second;
+	}
+
+}
+
+
+
+
+/*
+Function: reachable_from
+Input: map from integers to vectors of integers, set of integers
+Output: none
+
+Description: Given a map that represents a cascade of influence through a network,
+			 finds the total number of nodes influenced by a seed set of nodes S 
+			 using breadth-first search. The cascade is only read: nodes
+			 without outgoing edges are looked up, never inserted.
+*/
+int reachable_from(const map<int, vector<int> >& A, set<int>& S)
+{
+
+	static int tag = allocation_tag("REACHABLE_FROM");
+	AllocationScope scope(tag);
+
+	// initialize count of nodes reachable from seed set S in cascade A
+	int r = 0;
+
+	// initialize queue and set required to implement breadth-first search
+	queue<int> Q;
+	set<int> explored;
+
+	// for each seed node in S, do:
+	for (int s : S) {
+
+		// increment reachable count by one, as seed nodes can always reach
+		// themselves
+		r++;
+
+		// add seed node to BFS queue
+		Q.push(s);
+
+		// mark each node in seed set explored
+		explored.insert(s);
+	}
+
+	// while the queue is not empty, do
+	while (!Q.empty()) {
+
+		// set u equal to the node at the front of the queue and pop the queue
+		int u = Q.front();
+		Q.pop();
+
+		// a node without outgoing edges (or not in the cascade) has no key
+		auto edges = A.find(u);
+		if (edges == A.end()) {
+			continue;
+		}
+
+		// for each node v reachable via an outgoing edge from u, do
+		for (int v : edges->second) {
+
+			// if v has not been explored, mark it explored and do
+			if (explored.insert(v).second) {
+
+				// add v to the queue
+				Q.push(v);
+
+				// increment the number of nodes reachable from the seed set by one
+				r++;
+
+			}
+
+		}
+
+	}
+
+	// return number of nodes reachable in cascade A from seed set S
+	return r;
+
+}
+
+
+
+
+
+/*
+Function: total_reach
+Input: vector of maps, set of integers
+Output: long long
+
+Description: Given a vector of maps representing information cascades, returns
+the sum over the cascades of the number of nodes reachable from the seed set
+S. The sum is kept in an integer, so it is exact and does not depend on the
+order of the cascades.
+*/
+long long total_reach(const vector<map<int, vector<int> > >& cascades, set<int>& S)
+{
+
+	// initialize integer to store the total influence value
+	long long total = 0;
+
+	// for each cascade in the cascade vector, do
+	for (const map<int, vector<int> >& A : cascades) {
+
+		// calculate the number of reachable nodes from S in the cascade A (i.e.,
+		// the influence of S in A) and add it to the total influence value
+		total += reachable_from(A, S);
+
+	}
+
+	return total;
+
+}
+
+
+
+
+/*
+Function: calculate_influence
+Input: vector of maps, set of integers
+Output: double
+
+Description: Given a vector of maps representing information cascades. For each
+cascade, calculates the influence of a seed set of nodes S. Averages the numbers
+representing the influence of S under each cascade and returns this as the 
+overall influence of S.
+*/
+double calculate_influence(vector<map<int, vector<int> > >& cascades, set<int>& S)
+{
+
+	// divide total influence value by number of cascades to obtain final
+	// influence value
+	return (double)total_reach(cascades, S) / cascades.size();
+
+}
+
+
+
+
+
+/*
+Function: reference_greedy
+Input: vector of maps, set of ints, int, set of ints, pointer to vector of
+	   iteration rankings
+Output: double
+
+Description: The greedy algorithm of Kempe et al. as described above, kept in
+its straightforward form as the reference that every faster variant must
+agree with. Given the cascades and the set of all nodes in them, adds k
+nodes to S, one at a time, each time choosing the node whose addition
+increases the influence of S the most (the first such node in ascending
+order if there are ties), and returns the influence of the resulting set.
+Influence is compared as the integer sum of the reach over the cascades, so
+rounding never decides between two nodes. If rankings is given, the chosen
+node and the runners-up of each iteration are appended to it, from the gains
+the iteration computed anyway.
+*/
+double reference_greedy(vector<map<int, vector<int> > >& cascades, set<int>& V, int k, set<int>& S,
+	vector<IterationRanking>* rankings = NULL)
+{
+
+	// allocations of the search itself count toward REACHABLE_FROM
+	static int tag = allocation_tag("REFERENCE GREEDY");
+	AllocationScope scope(tag);
+
+	// initialize integer to store the previous total influence of the set
+	// (summed over the cascades)
+	long long previous_total = 0;
+
+	// number of candidates ranked per iteration: the chosen node and the
+	// runners-up
+	int ranked = max(PARAM_RUNNERS_UP, 0) + 1;
+
+	// for k iterations corresponding to the k nodes to be selected, do
+	for (int iter=0; iter<k; iter++) {
+
+		// initialize integers to store the maximum change in the 
+		// objective function in this iteration, the maximum influence of a set
+		// in this iteration, and the node corresponding to the maximally influential
+		// node this iteration given the approximately optimal set so far
+		long long max_delta = -1;
+		long long max_total = -1;
+		int max_delta_node = -1;
+
+		// the largest changes this iteration in descending order (ties in
+		// ascending order of node), the maximum change first
+		vector<pair<int, long long> > top;
+
+		// for each node u in all the cascades, do
+		for (int u : V) {
+
+			// if u is not already in the approximately optimal set,
+			if (S.find(u) == S.end()) {
+
+				// create a copy of the approximately optimal set and add u
+				set<int> T = S;
+				T.insert(u);
+
+				// calculate the influence of this new set
+				long long total_T = total_reach(cascades, T);
+
+				// calculate the change in the objective function when u is
+				// added to the approximately optimal set 
+				long long delta = total_T - previous_total;
+
+				// if this change is larger than the maximum change this iteration,
+				// update the maximum change to be the change corresponding to u,
+				// update the maximum influence of a set this iteration to be the
+				// influence of the approximately optimal set plus u, and update
+				// the maximally influential node given the approximately
+				// optimal set this iteration to be u
+				if (delta > max_delta) {
+					max_delta = delta;
+					max_total = total_T;
+					max_delta_node = u;
+				}
+
+				// keep u among the largest changes if it is one of them
+				if (rankings != NULL && ((int)top.size() < ranked || delta > top.back().second)) {
+					int i = top.size();
+					while (i > 0 && delta > top[i - 1].second) {
+						i--;
+					}
+					top.insert(top.begin() + i, make_pair(u, delta));
+					if ((int)top.size() > ranked) {
+						top.pop_back();
+					}
+				}
+
+			}
+
+		}
+
+		if (rankings != NULL && max_delta_node != -1) {
+			IterationRanking ranking;
+			for (pair<int, long long>& entry : top) {
+				ranking.top.push_back(make_pair(entry.first, (double)entry.second / cascades.size()));
+			}
+			rankings->push_back(ranking);
+		}
+
+		// add the maximally influential node to the approximately optimal set
+		S.insert(max_delta_node);
+
+		// update the previous influence value to be the influence of this new set
+		previous_total = max_total;
+
+	}
+
+	// return the influence of the approximately optimal set
+	return (double)previous_total / cascades.size();
+
+}
+
+
+
+
+
+/*
+Function: num_threads
+Input: none
+Output: int
+
+Description: Returns the number of worker threads to use: PARAM_THREADS, or
+all hardware threads if PARAM_THREADS is zero.
+*/
+int num_threads()
+{
+
+	if (PARAM_THREADS > 0) {
+		return PARAM_THREADS;
+	}
+
+	return max(1u, thread::hardware_concurrency());
+
+}
+
+
+
+
+/*
+Function: numa_cpus
+Input: vector of ints
+Output: vector of vectors of ints
+
+Description: Returns the CPUs of each NUMA node, as listed in
+/sys/devices/system/node, and fills node_ids with the numbers of the nodes.
+If the system lists no nodes, returns a single node 0 holding every hardware
+thread.
+*/
+vector<vector<int> > numa_cpus(vector<int>& node_ids)
+{
+
+	map<int, vector<int> > cpus_of_node;
+
+	error_code error;
+	for (auto entry : filesystem::directory_iterator("/sys/devices/system/node", error)) {
+
+		string name = entry.path().filename().string();
+
+		if (name.rfind("node", 0) != 0 || name.size() == 4 || !isdigit(name[4])) {
+			continue;
+		}
+
+		// cpulist holds ranges such as "0-3,8-11"
+		ifstream infile((entry.path() / "cpulist").string().c_str());
+		string list;
+		getline(infile, list);
+
+		vector<int>& cpus = cpus_of_node[stoi(name.substr(4))];
+
+		istringstream iss(list);
+		string range;
+		while (getline(iss, range, ',')) {
+
+			if (range == "") {
+				continue;
+			}
+
+			size_t dash = range.find('-');
+			int low = stoi(range.substr(0, dash));
+			int high = dash == string::npos ? low : stoi(range.substr(dash + 1));
+
+			for (int cpu = low; cpu <= high; cpu++) {
+				cpus.push_back(cpu);
+			}
+
+		}
+
+		if (cpus.empty()) {
+			cpus_of_node.erase(stoi(name.substr(4)));
+		}
+
+	}
+
+	vector<vector<int> > nodes;
+	node_ids.clear();
+	for (auto& entry : cpus_of_node) {
+		node_ids.push_back(entry.first);
+		nodes.push_back(entry.second);
+	}
+
+	if (nodes.empty()) {
+		node_ids.push_back(0);
+		nodes.push_back(vector<int>());
+		for (int cpu = 0; cpu < (int)thread::hardware_concurrency(); cpu++) {
+			nodes[0].push_back(cpu);
+		}
+	}
+
+	return nodes;
+
+}
+
+
+
+
+/*
+Structure: ThreadPool
+Description: Pool of num_threads() worker threads, created once on first use
+			 and kept for the rest of the program (loading and every greedy
+			 iteration). The calling thread takes part as worker 0. Workers
+			 are spread round-robin over the NUMA nodes; worker w belongs to
+			 node worker_node[w] and, if PARAM_PIN_THREADS is set, is pinned
+			 to one CPU of that node. Data that worker w allocates and touches
+			 first is therefore placed on its node.
+*/
+struct ThreadPool
+{
+
+	int size;
+	vector<thread> workers;
+	vector<int> worker_node;
+	vector<int> worker_cpu;
+	vector<int> node_ids;
+
+	// the job being run and the state of the workers
+	mutex lock;
+	condition_variable wake;
+	condition_variable done;
+	int generation = 0;
+	int finished = 0;
+	bool stopping = false;
+
+	const function<void(int, int)>* body = NULL;
+	int count = 0;
+	bool once_per_worker = false;
+	atomic<int> next{0};
+
+	// allocation phase of the thread that started the job
+	int job_tag = 0;
+
+	ThreadPool(int threads)
+	{
+		start(threads);
+	}
+
+	~ThreadPool()
+	{
+		stop();
+	}
+
+	// creates threads - 1 worker threads
+	void start(int threads)
+	{
+
+		size = threads;
+		worker_node.clear();
+		worker_cpu.clear();
+
+		vector<vector<int> > nodes = numa_cpus(node_ids);
+		int num_nodes = nodes.size();
+
+		for (int w = 0; w < size; w++) {
+			int node = w % num_nodes;
+			worker_node.push_back(node);
+			worker_cpu.push_back(nodes[node][(w / num_nodes) % nodes[node].size()]);
+		}
+
+		pin(0);
+
+		for (int w = 1; w < size; w++) {
+			workers.push_back(thread(&ThreadPool::loop, this, w));
+		}
+
+	}
+
+	// ends the worker threads
+	void stop()
+	{
+
+		{
+			lock_guard<mutex> guard(lock);
+			stopping = true;
+		}
+		wake.notify_all();
+
+		for (thread& t : workers) {
+			t.join();
+		}
+
+		workers.clear();
+		stopping = false;
+		generation = 0;
+
+	}
+
+	// replaces the workers with the given number of workers; used only by
+	// MODE_SCALING, everything else keeps the pool it started with
+	void resize(int threads)
+	{
+		stop();
+		start(threads);
+	}
+
+	// pins the calling thread to the CPU of worker w
+	void pin(int w)
+	{
+
+		if (!PARAM_PIN_THREADS) {
+			return;
+		}
+
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		CPU_SET(worker_cpu[w], &cpus);
+		pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+	}
+
+	// body of worker threads 1 to size - 1
+	void loop(int w)
+	{
+
+		pin(w);
+
+		int seen = 0;
+
+		while (true) {
+
+			{
+				unique_lock<mutex> guard(lock);
+				wake.wait(guard, [&] { return stopping || generation != seen; });
+				if (stopping) {
+					return;
+				}
+				seen = generation;
+			}
+
+			{
+				AllocationScope scope(job_tag);
+				work(w);
+			}
+
+			{
+				lock_guard<mutex> guard(lock);
+				finished++;
+			}
+			done.notify_one();
+
+		}
+
+	}
+
+	// runs worker w's share of the current job
+	void work(int w)
+	{
+
+		if (once_per_worker) {
+			if (w < count) {
+				(*body)(w, w);
+			}
+			return;
+		}
+
+		for (int i = next++; i < count; i = next++) {
+			(*body)(w, i);
+		}
+
+	}
+
+	// runs body(worker, i) for i in [0, count), or once on every worker
+	// (i = worker) if once_per_worker is set, and waits for it to finish
+	void run(int job_count, const function<void(int, int)>& job, bool job_once_per_worker)
+	{
+
+		{
+			lock_guard<mutex> guard(lock);
+			body = &job;
+			count = job_count;
+			once_per_worker = job_once_per_worker;
+			job_tag = current_allocation_tag;
+			next = 0;
+			finished = 0;
+			generation++;
+		}
+		wake.notify_all();
+
+		work(0);
+
+		unique_lock<mutex> guard(lock);
+		done.wait(guard, [&] { return finished == size - 1; });
+
+	}
+
+};
+
+
+
+
+/*
+Function: thread_pool
+Input: none
+Output: thread pool
+
+Description: Returns the program's thread pool, creating it on first use.
+*/
+ThreadPool& thread_pool()
+{
+
+	static ThreadPool pool(num_threads());
+
+	return pool;
+
+}
+
+
+
+
+/*
+Function: parallel_for
+Input: int, function of two ints
+Output: none
+
+Description: Calls body(worker, i) for every i in [0, count) on the thread pool
+and waits for all calls to finish. Items are handed out one at a time from a
+shared counter. worker is the number of the calling thread, so it can be used
+to pick per-thread scratch space.
+*/
+void parallel_for(int count, const function<void(int, int)>& body)
+{
+
+	thread_pool().run(count, body, false);
+
+}
+
+
+
+
+/*
+Function: for_each_worker
+Input: function of an int
+Output: none
+
+Description: Calls body(worker) exactly once on every worker of the thread
+pool and waits for all calls to finish. Used to give each worker its own
+share of the data, allocated and touched first on that worker's NUMA node.
+*/
+void for_each_worker(const function<void(int)>& body)
+{
+
+	thread_pool().run(thread_pool().size, [&](int worker, int) { body(worker); }, true);
+
+}
+
+
+
+
+/*
+Function: parse_edge_line
+Input: two pointers to chars, two ints
+Output: bool
+
+Description: Parses one line of an edgelist (the characters from p up to end,
+without the line break) in place, without copying it. Reads the first two
+integers of the line into from and to and ignores any further columns
+(weights, timestamps). Columns may be separated by spaces, tabs, commas or
+semicolons. Returns false for empty lines, comment lines (starting with
+POUND or PERCENT) and lines that do not start with two integers, such as
+column headers, or whose ids do not fit in an int.
+*/
+inline bool parse_edge_line(const char* p, const char* end, int& from, int& to)
+{
+
+	auto blank = [](char c) { return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r'; };
+
+	auto parse_int = [&](int& value) {
+
+		bool negative = p < end && *p == '-';
+		if (negative || (p < end && *p == '+')) {
+			p++;
+		}
+
+		if (p == end || *p < '0' || *p > '9') {
+			return false;
+		}
+
+		// ids that do not fit in an int are rejected, not wrapped around
+		long long x = 0;
+		while (p < end && *p >= '0' && *p <= '9') {
+			x = x * 10 + (*p++ - '0');
+			if (x > (long long)INT_MAX + 1) {
+				return false;
+			}
+		}
+
+		if (x > (long long)INT_MAX + negative) {
+			return false;
+		}
+
+		value = negative ? -x : x;
+		return true;
+
+	};
+
+	while (p < end && blank(*p)) {
+		p++;
+	}
+
+	if (p == end || *p == POUND || *p == PERCENT) {
+		return false;
+	}
+
+	if (!parse_int(from) || p == end || !blank(*p)) {
+		return false;
+	}
+
+	while (p < end && blank(*p)) {
+		p++;
+	}
+
+	return parse_int(to) && (p == end || blank(*p));
+
+}
+
+
+
+
+/*
+Function: detect_format
+Input: two pointers to chars
+Output: int
+
+Description: Guesses the format of an edgelist from its first line: Matrix
+Market files start with "%%MatrixMarket", KONECT files with a comment line
+starting with PERCENT, and anything else is read as a SNAP edgelist.
+*/
+int detect_format(const char* p, const char* end)
+{
+
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+		p++;
+	}
+
+	string start(p, min(end, p + 14));
+
+	if (start == "%%MatrixMarket") {
+		return FORMAT_MATRIX_MARKET;
+	}
+	if (start != "" && start[0] == PERCENT) {
+		return FORMAT_KONECT;
+	}
+
+	return FORMAT_SNAP;
+
+}
+
+
+
+
+/*
+Function: parse_edge_list
+Input: two pointers to chars, vector of pairs of ints
+Output: none
+
+Description: Appends the edges of the edgelist stored from p up to end to
+edges, in the format given by PARAM_INPUT_FORMAT (detected from the first
+line if it is FORMAT_AUTO). In Matrix Market files, the first line that is
+not a comment gives the matrix size and is skipped. KONECT and Matrix Market
+ids start at 1; with PARAM_ZERO_BASED_IDS set, they are shifted to start at
+0 like those of SNAP files.
+*/
+void parse_edge_list(const char* p, const char* end, vector<pair<int, int> >& edges)
+{
+
+	int format = PARAM_INPUT_FORMAT == FORMAT_AUTO ? detect_format(p, end) : PARAM_INPUT_FORMAT;
+	int shift = (PARAM_ZERO_BASED_IDS && format != FORMAT_SNAP) ? 1 : 0;
+	bool size_line = format == FORMAT_MATRIX_MARKET;
+
+	while (p < end) {
+
+		const char* line_end = (const char*)memchr(p, '\n', end - p);
+		if (line_end == NULL) {
+			line_end = end;
+		}
+
+		int from;
+		int to;
+
+		if (parse_edge_line(p, line_end, from, to)) {
+			if (size_line) {
+				size_line = false;
+			}
+			else {
+				edges.push_back(make_pair(from - shift, to - shift));
+			}
+		}
+
+		p = line_end + 1;
+
+	}
+
+}
+
+
+
+
+/*
+Function: parse_cascade_weight
+Input: two pointers to chars
+Output: double
+
+Description: Returns the weight w given by a "# weight w" comment line (as
+written by run_coreset) among the comment lines at the start of the edgelist
+stored from p up to end, or 1 if there is none. Returns -1 if the line does
+not hold a positive finite number followed by nothing but blanks, so the
+caller can reject the file.
+*/
+double parse_cascade_weight(const char* p, const char* end)
+{
+
+	const string prefix = "# weight ";
+
+	while (p < end) {
+
+		const char* line_end = (const char*)memchr(p, '\n', end - p);
+		if (line_end == NULL) {
+			line_end = end;
+		}
+
+		while (p < line_end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+			p++;
+		}
+
+		// the weight comes before the first edge
+		if (p < line_end && *p != POUND && *p != PERCENT) {
+			break;
+		}
+
+		if (line_end - p >= (ptrdiff_t)prefix.size() && equal(prefix.begin(), prefix.end(), p)) {
+
+			string value(p + prefix.size(), line_end);
+			char* value_end;
+			double weight = strtod(value.c_str(), &value_end);
+
+			bool number = value_end != value.c_str();
+			while (*value_end == ' ' || *value_end == '\t' || *value_end == '\r') {
+				value_end++;
+			}
+
+			return (number && *value_end == '\0' && isfinite(weight) && weight > 0) ? weight : -1.0;
+
+		}
+
+		p = line_end + 1;
+
+	}
+
+	return 1.0;
+
+}
+
+
+
+
+/*
+Function: read_all
+Input: int, vector of chars
+Output: none
+
+Description: Reads the file descriptor to its end into the buffer. For
+regular files, the buffer is sized from the file size up front.
+*/
+void read_all(int fd, vector<char>& buffer)
+{
+
+	struct stat info;
+	size_t size = 0;
+	buffer.resize(fstat(fd, &info) == 0 && S_ISREG(info.st_mode) ? info.st_size + 1 : 1 << 16);
+
+	while (true) {
+
+		if (size == buffer.size()) {
+			buffer.resize(2 * size);
+		}
+
+		ssize_t n = read(fd, buffer.data() + size, buffer.size() - size);
+
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			break;
+		}
+
+		size += n;
+
+	}
+
+	buffer.resize(size);
+
+}
+
+
+
+
+/*
+Function: read_edge_list
+Input: string, vector of pairs of ints, pointer to double
+Output: none
+
+Description: Appends the edges of the edgelist file to edges (see
+parse_edge_list). If weight is given, sets it to the cascade's weight (see
+parse_cascade_weight). Regular files are mapped into memory and parsed where
+they lie; other files (pipes, devices) are read into a buffer first.
+*/
+void read_edge_list(string path, vector<pair<int, int> >& edges, double* weight = NULL)
+{
+
+	int fd = open(path.c_str(), O_RDONLY);
+
+	if (fd == -1) {
+		return;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+
+		void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (mapping != MAP_FAILED) {
+			madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+			parse_edge_list((const char*)mapping, (const char*)mapping + info.st_size, edges);
+			if (weight != NULL) {
+				*weight = parse_cascade_weight((const char*)mapping, (const char*)mapping + info.st_size);
+			}
+			munmap(mapping, info.st_size);
+			close(fd);
+			return;
+		}
+
+	}
+
+	vector<char> buffer;
+	read_all(fd, buffer);
+	close(fd);
+
+	parse_edge_list(buffer.data(), buffer.data() + buffer.size(), edges);
+	if (weight != NULL) {
+		*weight = parse_cascade_weight(buffer.data(), buffer.data() + buffer.size());
+	}
+
+}
+
+
+
+
+/*
+Function: insert_edges
+Input: set of ints, map from ints to vectors of ints, vector of pairs of ints
+Output: none
+
+Description: Adds the edges to the adjacency list of the cascade, and their
+nodes to the set of all nodes in all the cascades.
+*/
+void insert_edges(set<int>& V, map<int, vector<int> >& A, vector<pair<int, int> >& edges)
+{
+
+	for (pair<int, int>& edge : edges) {
+
+		// add nodes to map representing adjacency list
+		A[edge.first].push_back(edge.second);
+
+		// add nodes to set of all nodes in all the cascades
+		V.insert(edge.second);
+		V.insert(edge.first);
+
+	}
+
+}
+
+
+
+
+/*
+Function: create_cascade
+Input: set of ints, map from ints to vectors of ints, string, pointer to double
+Output: none
+
+Description: Given a set of ints representing all the nodes in all the cascades
+in the dataset, a map that will represent a single cascade as an adjacency list, 
+and a string representing a file name. Reads the edgelist specified in the 
+cascade .txt file (SNAP, KONECT or Matrix Market, see read_edge_list) and puts
+this information into the map. Also adds each node in 
+the cascade file to the set of all nodes in all the cascades. If weight is
+given, sets it to the weight of the cascade (see parse_cascade_weight).
+*/
+void create_cascade(set<int>& V, map<int, vector<int> >& A, string graph_file_name, double* weight = NULL)
+{
+
+	// read the edges of the cascade file
+	vector<pair<int, int> > edges;
+	read_edge_list(graph_file_name, edges, weight);
+
+	insert_edges(V, A, edges);
+
+}
+
+
+
+
+/*
+Function: list_cascade_files
+Input: string, vector of strings
+Output: none
+
+Description: Appends the paths of the .txt files in the directory to the
+vector of cascade file paths, in ascending order, so that the order of the
+cascades does not depend on the order the file system lists them in.
+*/
+void list_cascade_files(string directory, vector<string>& graph_file_names)
+{
+
+	int first = graph_file_names.size();
+
+	// for each file in the cascade directory, do
+	for (auto file : filesystem::directory_iterator(directory)) {
+
+		// get file path string
+		string file_path = file.path();
+
+		// if the file is a .txt file, add the file path to the vector of cascade
+		// file paths
+		if (file_path.find(".txt") != -1) {
+			graph_file_names.push_back(file_path);
+		}
+
+	}
+
+	sort(graph_file_names.begin() + first, graph_file_names.end());
+
+}
+
+
+
+
+/*
+Function: get_cascade_vector
+Input: set of ints, vector of maps, vector of strings, string, pointer to
+	   vector of doubles
+Output: none
+
+Description: Given a set of ints representing all the nodes in all the cascades
+in the dataset, a vector of maps that will contain all of the cascades in
+the dataset, and a vector of strings that will contain the cascade file paths.
+Collects the file names in the directory containing the cascade files
+(CASCADE_DIRECTORY unless another directory is given). Reads
+the information in each cascade file into a map and adds this map to the
+cascade vector, spreading the files over the thread pool. The file paths are
+appended to the vector of cascade file paths and the cascades to the cascade
+vector, in the same order. If weights is given, the weight of each cascade
+(see parse_cascade_weight) is appended to it in the same order.
+*/
+void get_cascade_vector(set<int>& V, vector<map<int, vector<int> > >& cascades, vector<string>& graph_file_names,
+	string directory = CASCADE_DIRECTORY, vector<double>* weights = NULL)
+{
+
+	int first_name = graph_file_names.size();
+	list_cascade_files(directory, graph_file_names);
+
+	// initialize one map per cascade file that will represent the information
+	// in the file as an adjacency list, and one set of nodes per worker thread
+	int first = cascades.size();
+	int n = graph_file_names.size() - first_name;
+	cascades.resize(first + n);
+	vector<set<int> > worker_nodes(thread_pool().size);
+	if (weights != NULL) {
+		weights->resize(first + n, 1.0);
+	}
+
+	// for each file path in the vector of cascade file paths, populate its
+	// map with the information in the cascade file on one of the worker
+	// threads; also add the nodes in the cascade to the worker's set of nodes
+	parallel_for(n, [&](int worker, int i) {
+		create_cascade(worker_nodes[worker], cascades[first + i], graph_file_names[first_name + i],
+			weights != NULL ? &(*weights)[first + i] : NULL);
+	});
+
+	// add the nodes seen by each worker to the set of all nodes in all the cascades
+	for (set<int>& nodes : worker_nodes) {
+		V.insert(nodes.begin(), nodes.end());
+	}
+
+}
+
+
+
+
+/*
+Function: allocate_flat
+Input: size_t
+Output: pointer
+
+Description: Allocates memory for a flat array of the given number of bytes.
+Arrays of at least HUGE_PAGE_BYTES are mapped directly from the kernel,
+aligned to HUGE_PAGE_BYTES and rounded up to a multiple of it, and backed as
+set by use_huge_pages: with reserved huge pages from hugetlbfs if any are
+free (HUGE_PAGES_RESERVED), with transparent huge pages (madvise with
+MADV_HUGEPAGE), or with ordinary pages (HUGE_PAGES_OFF). Smaller arrays come
+from operator new.
+*/
+void* allocate_flat(size_t bytes)
+{
+
+	if (bytes < HUGE_PAGE_BYTES) {
+		return ::operator new(bytes);
+	}
+
+	size_t rounded = (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+
+	// hugetlbfs mappings are aligned and rounded by the kernel
+	if (use_huge_pages == HUGE_PAGES_RESERVED) {
+		void* p = mmap(NULL, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (p != MAP_FAILED) {
+			return p;
+		}
+	}
+
+	// map one huge page more than needed and trim the ends to align the array
+	char* p = (char*)mmap(NULL, rounded + HUGE_PAGE_BYTES, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (p == MAP_FAILED) {
+		throw bad_alloc();
+	}
+
+	char* aligned = (char*)(((uintptr_t)p + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES);
+
+	if (aligned != p) {
+		munmap(p, aligned - p);
+	}
+	if (aligned + rounded != p + rounded + HUGE_PAGE_BYTES) {
+		munmap(aligned + rounded, p + rounded + HUGE_PAGE_BYTES - (aligned + rounded));
+	}
+
+	madvise(aligned, rounded, use_huge_pages == HUGE_PAGES_OFF ? MADV_NOHUGEPAGE : MADV_HUGEPAGE);
+
+	return aligned;
+
+}
+
+
+
+
+/*
+Function: free_flat
+Input: pointer, size_t
+Output: none
+
+Description: Frees a flat array of the given number of bytes allocated by
+allocate_flat.
+*/
+void free_flat(void* p, size_t bytes)
+{
+
+	if (bytes < HUGE_PAGE_BYTES) {
+		::operator delete(p);
+		return;
+	}
+
+	munmap(p, (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES);
+
+}
+
+
+
+
+/*
+Structure: HugePageAllocator
+Description: Allocator that gets its memory from allocate_flat, used for the
+			 large flat arrays that traversals jump around in (the arrays of
+			 the cascade index, the traversal stamps and the coverage). With
+			 huge pages, one dTLB entry covers 2 MB of such an array instead
+			 of 4 KB.
+*/
+template <class T>
+struct HugePageAllocator
+{
+
+	typedef T value_type;
+
+	HugePageAllocator() {}
+
+	template <class U>
+	HugePageAllocator(const HugePageAllocator<U>&) {}
+
+	T* allocate(size_t n)
+	{
+		return (T*)allocate_flat(n * sizeof(T));
+	}
+
+	void deallocate(T* p, size_t n)
+	{
+		free_flat(p, n * sizeof(T));
+	}
+
+};
+
+template <class T, class U>
+bool operator==(const HugePageAllocator<T>&, const HugePageAllocator<U>&)
+{
+	return true;
+}
+
+template <class T, class U>
+bool operator!=(const HugePageAllocator<T>&, const HugePageAllocator<U>&)
+{
+	return false;
+}
+
+// flat arrays of ints (offsets, targets, stamps, marks) and of flags (coverage)
+typedef vector<int, HugePageAllocator<int> > FlatInts;
+typedef vector<char, HugePageAllocator<char> > FlatFlags;
+
+
+
+
+/*
+Structure: IdRange
+Description: Range of ids stored as a plain array.
+*/
+struct IdRange
+{
+	const int* first;
+	const int* last;
+	const int* begin() const { return first; }
+	const int* end() const { return last; }
+};
+
+
+
+
+/*
+Structure: CascadeIndex
+Description: Flat copy of the vector of cascades used by the coverage-based
+			 variants of the greedy algorithm. Every node of every cascade is
+			 given a "slot"; the slots of cascade c are the range
+			 [cascade_begin[c], cascade_begin[c + 1]). Edges are stored between
+			 slots in compressed sparse row form. Nodes are renumbered densely
+			 in ascending order of their labels, so comparing the dense ids of
+			 two nodes compares their labels. The index is itself a storage
+			 backend (see "Cascade storage backends" below), with slots as
+			 ids, so the traversals of the engines are templates over it.
+*/
+struct CascadeIndex
+{
+
+	// dense node id -> node label, in ascending order
+	vector<int> labels;
+
+	// cascade -> first slot of the cascade (plus one entry past the end)
+	FlatInts cascade_begin;
+
+	// slot -> cascade containing the slot, and slot -> dense id of its node
+	FlatInts slot_cascade;
+	FlatInts slot_node;
+
+	// slot -> first outgoing edge (plus one entry past the end), and
+	// edge -> target slot
+	FlatInts edge_begin;
+	FlatInts edge_target;
+
+	// dense node id -> first occurrence (plus one entry past the end), and
+	// occurrence -> slot of the node, in ascending order of cascade
+	FlatInts occurrence_begin;
+	FlatInts occurrence_slot;
+
+	int num_cascades() { return cascade_begin.size() - 1; }
+	int num_ids() { return slot_node.size(); }
+	int num_nodes() { return labels.size(); }
+	int cascade(int id) { return slot_cascade[id]; }
+	IdRange neighbors(int id) { return IdRange{edge_target.data() + edge_begin[id], edge_target.data() + edge_begin[id + 1]}; }
+	IdRange occurrences(int d) { return IdRange{occurrence_slot.data() + occurrence_begin[d], occurrence_slot.data() + occurrence_begin[d + 1]}; }
+
+};
+
+
+
+
+/*
+Structure: TraversalScratch
+Description: Scratch space for breadth-first searches over a CascadeIndex. A
+			 slot counts as visited when its stamp equals the stamp of the
+			 current search, so the marks never have to be cleared between
+			 searches. Each thread needs its own scratch.
+*/
+struct TraversalScratch
+{
+
+	// slot -> stamp of the last search that visited the slot
+	FlatInts stamp;
+
+	// stamp of the current search
+	int current = 0;
+
+	// breadth-first search queue, reused between searches
+	vector<int> queue;
+
+};
+
+
+
+
+/*
+Structure: CascadeBlock
+Description: One cascade flattened on its own, before it is appended to a
+			 cascade index. Slot i of the block holds the i-th smallest label
+			 of the cascade; edges are stored between the slots of the block
+			 in compressed sparse row form.
+*/
+struct CascadeBlock
+{
+
+	// slot -> node label, in ascending order
+	vector<int> slot_labels;
+
+	// slot -> first outgoing edge (plus one entry past the end), and
+	// edge -> target slot of the block
+	vector<int> edge_begin;
+	vector<int> edge_target;
+
+};
+
+
+
+
+/*
+Function: flatten_cascade
+Input: map from ints to vectors of ints, cascade block
+Output: none
+
+Description: Fills the block with a flat copy of the cascade (see
+CascadeBlock).
+*/
+void flatten_cascade(map<int, vector<int> >& A, CascadeBlock& block)
+{
+
+	// collect the labels of the nodes in this cascade in ascending order;
+	// the i-th of them gets the i-th slot of the cascade
+	block.slot_labels.clear();
+	for (auto& entry : A) {
+		block.slot_labels.push_back(entry.first);
+		block.slot_labels.insert(block.slot_labels.end(), entry.second.begin(), entry.second.end());
+	}
+	sort(block.slot_labels.begin(), block.slot_labels.end());
+	block.slot_labels.erase(unique(block.slot_labels.begin(), block.slot_labels.end()), block.slot_labels.end());
+
+	block.edge_begin.assign(1, 0);
+	block.edge_target.clear();
+
+	// translate the adjacency list of each node into slot-to-slot edges
+	for (int label : block.slot_labels) {
+
+		auto found = A.find(label);
+
+		if (found != A.end()) {
+			for (int to : found->second) {
+				block.edge_target.push_back(lower_bound(block.slot_labels.begin(), block.slot_labels.end(), to)
+					- block.slot_labels.begin());
+			}
+		}
+
+		block.edge_begin.push_back(block.edge_target.size());
+
+	}
+
+}
+
+
+
+
+/*
+Function: append_block
+Input: cascade index, cascade block
+Output: none
+
+Description: Appends the block to the cascade index as its next cascade. Until
+finish_cascade_index is called, slot_node holds the labels of the nodes
+instead of their dense ids.
+*/
+void append_block(CascadeIndex& index, CascadeBlock& block)
+{
+
+	if (index.cascade_begin.empty()) {
+		index.cascade_begin.assign(1, 0);
+		index.edge_begin.assign(1, 0);
+	}
+
+	int c = index.cascade_begin.size() - 1;
+	int first_slot = index.slot_node.size();
+	int first_edge = index.edge_target.size();
+
+	index.slot_cascade.insert(index.slot_cascade.end(), block.slot_labels.size(), c);
+	index.slot_node.insert(index.slot_node.end(), block.slot_labels.begin(), block.slot_labels.end());
+
+	for (int i = 1; i < (int)block.edge_begin.size(); i++) {
+		index.edge_begin.push_back(first_edge + block.edge_begin[i]);
+	}
+	for (int target : block.edge_target) {
+		index.edge_target.push_back(first_slot + target);
+	}
+
+	index.cascade_begin.push_back(index.slot_node.size());
+
+}
+
+
+
+
+/*
+Function: finish_cascade_index
+Input: cascade index
+Output: none
+
+Description: Numbers the nodes of a cascade index whose blocks have all been
+appended (see append_block) densely in ascending order of their labels, and
+groups the slots by node.
+*/
+void finish_cascade_index(CascadeIndex& index)
+{
+
+	if (index.cascade_begin.empty()) {
+		index.cascade_begin.assign(1, 0);
+		index.edge_begin.assign(1, 0);
+	}
+
+	// collect the labels of all nodes in the cascades in ascending order
+	vector<int> labels(index.slot_node.begin(), index.slot_node.end());
+	sort(labels.begin(), labels.end());
+	labels.erase(unique(labels.begin(), labels.end()), labels.end());
+
+	for (int& d : index.slot_node) {
+		d = lower_bound(labels.begin(), labels.end(), d) - labels.begin();
+	}
+
+	index.labels = labels;
+
+	// group the slots by node; slots are visited in cascade order, so the
+	// occurrences of each node end up in ascending order of cascade
+	index.occurrence_begin.assign(labels.size() + 1, 0);
+	for (int d : index.slot_node) {
+		index.occurrence_begin[d + 1]++;
+	}
+	for (int d = 0; d < (int)labels.size(); d++) {
+		index.occurrence_begin[d + 1] += index.occurrence_begin[d];
+	}
+
+	vector<int> next(index.occurrence_begin.begin(), index.occurrence_begin.end() - 1);
+	index.occurrence_slot.resize(index.slot_node.size());
+	for (int slot = 0; slot < (int)index.slot_node.size(); slot++) {
+		index.occurrence_slot[next[index.slot_node[slot]]++] = slot;
+	}
+
+}
+
+
+
+
+// The cascades loaded by the pipelined load (see load_pipeline) and the index
+// it built for them, which build_cascade_index hands out instead of building
+// the same index again
+vector<map<int, vector<int> > >* pipelined_cascades = NULL;
+CascadeIndex* pipelined_index = NULL;
+
+
+
+
+/*
+Function: build_cascade_index
+Input: vector of maps, cascade index, two ints
+Output: none
+
+Description: Given a vector of maps representing information cascades, fills
+the cascade index with a flat copy of the cascades first to last - 1 (all of
+them by default; see CascadeIndex). Cascade first becomes cascade 0 of the
+index. If the pipelined load already built the index of all the cascades, it
+is copied instead.
+*/
+void build_cascade_index(vector<map<int, vector<int> > >& cascades, CascadeIndex& index, int first = 0, int last = -1)
+{
+
+	if (last == -1) {
+		last = cascades.size();
+	}
+
+	if (&cascades == pipelined_cascades && first == 0 && last == (int)cascades.size()) {
+		index = *pipelined_index;
+		return;
+	}
+
+	index.cascade_begin.clear();
+	index.slot_cascade.clear();
+	index.slot_node.clear();
+	index.edge_begin.clear();
+	index.edge_target.clear();
+
+	// flatten each cascade and append it to the index
+	CascadeBlock block;
+	for (int c = first; c < last; c++) {
+		flatten_cascade(cascades[c], block);
+		append_block(index, block);
+	}
+
+	finish_cascade_index(index);
+
+}
+
+
+
+
+/*
+Function: cascade_bytes
+Input: vector of maps
+Output: size_t
+
+Description: Returns an estimate of the memory used by the vector of maps: each
+entry of a map takes a tree node of about 48 bytes plus the entry itself and
+its adjacency list.
+*/
+size_t cascade_bytes(vector<map<int, vector<int> > >& cascades)
+{
+
+	size_t bytes = cascades.capacity() * sizeof(map<int, vector<int> >);
+
+	for (map<int, vector<int> >& A : cascades) {
+		for (auto& entry : A) {
+			bytes += 48 + sizeof(entry) + entry.second.capacity() * sizeof(int);
+		}
+	}
+
+	return bytes;
+
+}
+
+
+
+
+/*
+Function: index_bytes
+Input: cascade index
+Output: size_t
+
+Description: Returns the memory used by the arrays of the cascade index.
+*/
+size_t index_bytes(CascadeIndex& index)
+{
+
+	return sizeof(int) * (index.labels.size() + index.cascade_begin.size() + index.slot_cascade.size()
+		+ index.slot_node.size() + index.edge_begin.size() + index.edge_target.size()
+		+ index.occurrence_begin.size() + index.occurrence_slot.size());
+
+}
+
+
+
+
+/*
+Function: prepare_scratch
+Input: storage, traversal scratch
+Output: none
+
+Description: Sizes a traversal scratch for searches over the storage (a
+cascade index or a storage backend).
+*/
+template <class Store>
+void prepare_scratch(Store& store, TraversalScratch& scratch)
+{
+
+	scratch.stamp.assign(store.num_ids(), 0);
+	scratch.current = 0;
+	scratch.queue.clear();
+
+}
+
+
+
+
+/*
+Structure: CascadeStats
+Description: Statistics of every cascade of a cascade index, computed by the
+			 pipelined load (see load_pipeline). A cascade is a forest if it
+			 has no cycles and no slot has more than one incoming edge; then
+			 the reach bound of every slot is the exact number of slots it
+			 reaches. lazy_greedy starts its queue from these bounds.
+*/
+struct CascadeStats
+{
+
+	// cascade -> whether it is a forest, and whether it has no cycles
+	FlatFlags forest;
+	FlatFlags acyclic;
+
+	// the slots of each cascade in topological order (the slots of cascade c
+	// take the range [cascade_begin[c], cascade_begin[c + 1]), like in the
+	// index; slots on cycles come last, in slot order)
+	FlatInts topological_order;
+
+	// slot -> upper bound on the number of slots reachable from the slot
+	// (including the slot itself)
+	FlatInts reach_bound;
+
+};
+
+// The statistics the pipelined load computed for pipelined_cascades
+CascadeStats* pipelined_stats = NULL;
+
+
+
+
+/*
+Function: cascade_statistics
+Input: cascade block, int, cascade stats
+Output: none
+
+Description: Appends the statistics of the cascade in the block, whose first
+slot in the index is first_slot, to the cascade stats (see CascadeStats). The
+reach bound of a slot is one more than the sum of the bounds of its targets,
+computed in reverse topological order, and at most the size of the cascade.
+*/
+void cascade_statistics(CascadeBlock& block, int first_slot, CascadeStats& stats)
+{
+
+	int n = block.slot_labels.size();
+
+	vector<int> indegree(n, 0);
+	for (int target : block.edge_target) {
+		indegree[target]++;
+	}
+
+	bool in_tree = true;
+	for (int s = 0; s < n; s++) {
+		in_tree = in_tree && indegree[s] <= 1;
+	}
+
+	// order the slots with Kahn's algorithm
+	vector<int> order;
+	for (int s = 0; s < n; s++) {
+		if (indegree[s] == 0) {
+			order.push_back(s);
+		}
+	}
+	for (int head = 0; head < (int)order.size(); head++) {
+		for (int e = block.edge_begin[order[head]]; e < block.edge_begin[order[head] + 1]; e++) {
+			if (--indegree[block.edge_target[e]] == 0) {
+				order.push_back(block.edge_target[e]);
+			}
+		}
+	}
+
+	bool acyclic = (int)order.size() == n;
+
+	// a cycle on which every slot has one incoming edge is not a forest
+	bool forest = in_tree && acyclic;
+
+	// the slots left over lie on or behind a cycle and reach at most the
+	// whole cascade
+	vector<long long> bound(n, n);
+	for (int s = 0; s < n && !acyclic; s++) {
+		if (indegree[s] > 0) {
+			order.push_back(s);
+		}
+	}
+
+	for (int i = acyclic ? n - 1 : -1; i >= 0; i--) {
+		int s = order[i];
+		long long b = 1;
+		for (int e = block.edge_begin[s]; e < block.edge_begin[s + 1]; e++) {
+			b += bound[block.edge_target[e]];
+		}
+		bound[s] = min(b, (long long)n);
+	}
+
+	stats.forest.push_back(forest);
+	stats.acyclic.push_back(acyclic);
+	for (int s : order) {
+		stats.topological_order.push_back(first_slot + s);
+	}
+	for (int s = 0; s < n; s++) {
+		stats.reach_bound.push_back(bound[s]);
+	}
+
+}
+
+
+
+
+/*
+Function: build_cascade_stats
+Input: vector of maps, cascade stats
+Output: none
+
+Description: Fills the cascade stats of all the cascades, whose slots are
+numbered as in build_cascade_index. Copies the statistics of the pipelined
+load if it already computed them.
+*/
+void build_cascade_stats(vector<map<int, vector<int> > >& cascades, CascadeStats& stats)
+{
+
+	if (&cascades == pipelined_cascades && pipelined_stats != NULL) {
+		stats = *pipelined_stats;
+		return;
+	}
+
+	stats = CascadeStats();
+
+	CascadeBlock block;
+	int first_slot = 0;
+	for (map<int, vector<int> >& A : cascades) {
+		flatten_cascade(A, block);
+		cascade_statistics(block, first_slot, stats);
+		first_slot += block.slot_labels.size();
+	}
+
+}
+
+
+
+
+/*
+Structure: SpscQueue
+Description: Bounded queue between two stages of the pipelined load, with
+			 exactly one thread pushing and one thread popping, so it needs
+			 no lock. Pushing into a full queue waits until the consumer has
+			 popped, which keeps a fast stage from running ahead of a slow
+			 one (and bounds the memory of the items in flight).
+*/
+template <class T>
+struct SpscQueue
+{
+
+	// ring buffer; the i-th item pushed is kept at i % items.size()
+	vector<T> items;
+
+	// number of items popped (written by the consumer only) and pushed
+	// (written by the producer only), on separate cache lines
+	alignas(64) atomic<size_t> popped{0};
+	alignas(64) atomic<size_t> pushed{0};
+
+	// waits a little longer the longer the other side has been idle, so a
+	// stage that waits does not take the CPU from the stage it waits for
+	static void wait(int spins)
+	{
+
+		if (spins < 64) {
+			this_thread::yield();
+		}
+		else {
+			this_thread::sleep_for(chrono::microseconds(min(spins, 1000)));
+		}
+
+	}
+
+	void push(T item)
+	{
+
+		size_t n = pushed.load(memory_order_relaxed);
+		for (int spins = 0; n - popped.load(memory_order_acquire) == items.size(); spins++) {
+			wait(spins);
+		}
+
+		items[n % items.size()] = item;
+		pushed.store(n + 1, memory_order_release);
+
+	}
+
+	T pop()
+	{
+
+		size_t n = popped.load(memory_order_relaxed);
+		for (int spins = 0; pushed.load(memory_order_acquire) == n; spins++) {
+			wait(spins);
+		}
+
+		T item = items[n % items.size()];
+		popped.store(n + 1, memory_order_release);
+
+		return item;
+
+	}
+
+};
+
+
+
+
+/*
+Function: load_pipeline
+Input: set of ints, vector of maps, vector of strings, cascade index, cascade
+	   stats, string, pointer to vector of doubles
+Output: none
+
+Description: Same as get_cascade_vector, but also builds the cascade index
+and the statistics of the cascades read, in one pass. The files go through
+four stages that run at the same time, connected by SpscQueues of
+PARAM_PIPELINE_DEPTH cascades: one thread reads the files into memory,
+PARAM_PIPELINE_PARSERS threads parse them (file i goes to parser i modulo
+PARAM_PIPELINE_PARSERS, so no queue has more than one producer or consumer),
+one thread flattens each cascade into a block (see flatten_cascade), and the
+calling thread computes the statistics of each block and appends it to the
+index. The load takes about as long as its slowest stage. Prints the time
+each stage was busy.
+*/
+void load_pipeline(set<int>& V, vector<map<int, vector<int> > >& cascades, vector<string>& graph_file_names,
+	CascadeIndex& index, CascadeStats& stats, string directory = CASCADE_DIRECTORY, vector<double>* weights = NULL)
+{
+
+	auto start = chrono::high_resolution_clock::now();
+
+	int first_name = graph_file_names.size();
+	list_cascade_files(directory, graph_file_names);
+
+	int first = cascades.size();
+	int n = graph_file_names.size() - first_name;
+	int parsers = max(1, PARAM_PIPELINE_PARSERS);
+	cascades.resize(first + n);
+	if (weights != NULL) {
+		weights->resize(first + n, 1.0);
+	}
+
+	// the contents of the files read but not yet parsed, the blocks flattened
+	// but not yet appended, and the nodes seen by each parser
+	vector<vector<char> > contents(n);
+	vector<CascadeBlock> blocks(n);
+	vector<set<int> > parser_nodes(parsers);
+
+	vector<SpscQueue<int> > to_parse(parsers);
+	vector<SpscQueue<int> > to_flatten(parsers);
+	SpscQueue<int> to_append;
+	for (int p = 0; p < parsers; p++) {
+		to_parse[p].items.resize(PARAM_PIPELINE_DEPTH);
+		to_flatten[p].items.resize(PARAM_PIPELINE_DEPTH);
+	}
+	to_append.items.resize(PARAM_PIPELINE_DEPTH);
+
+	// seconds each stage spent working (not waiting for its neighbors)
+	double read_seconds = 0, flatten_seconds = 0, append_seconds = 0;
+	vector<double> parse_seconds(parsers, 0);
+
+	auto seconds_since = [](chrono::high_resolution_clock::time_point t) {
+		return chrono::duration<double>(chrono::high_resolution_clock::now() - t).count();
+	};
+
+	vector<thread> stages;
+
+	// the stages count their allocations toward the caller's phase
+	int tag = current_allocation_tag;
+
+	// read the files in order
+	stages.emplace_back([&]() {
+		AllocationScope scope(tag);
+		for (int i = 0; i < n; i++) {
+			auto t = chrono::high_resolution_clock::now();
+			int fd = open(graph_file_names[first_name + i].c_str(), O_RDONLY);
+			if (fd != -1) {
+				read_all(fd, contents[i]);
+				close(fd);
+			}
+			read_seconds += seconds_since(t);
+			to_parse[i % parsers].push(i);
+		}
+	});
+
+	// parse every parsers-th file into its map
+	for (int p = 0; p < parsers; p++) {
+		stages.emplace_back([&, p]() {
+			AllocationScope scope(tag);
+			vector<pair<int, int> > edges;
+			for (int j = p; j < n; j += parsers) {
+				int i = to_parse[p].pop();
+				auto t = chrono::high_resolution_clock::now();
+				edges.clear();
+				parse_edge_list(contents[i].data(), contents[i].data() + contents[i].size(), edges);
+				if (weights != NULL) {
+					(*weights)[first + i] = parse_cascade_weight(contents[i].data(), contents[i].data() + contents[i].size());
+				}
+				vector<char>().swap(contents[i]);
+				insert_edges(parser_nodes[p], cascades[first + i], edges);
+				parse_seconds[p] += seconds_since(t);
+				to_flatten[p].push(i);
+			}
+		});
+	}
+
+	// flatten the cascades in order, taking them from the parsers in turn
+	stages.emplace_back([&]() {
+		AllocationScope scope(tag);
+		for (int j = 0; j < n; j++) {
+			int i = to_flatten[j % parsers].pop();
+			auto t = chrono::high_resolution_clock::now();
+			flatten_cascade(cascades[first + i], blocks[i]);
+			flatten_seconds += seconds_since(t);
+			to_append.push(i);
+		}
+	});
+
+	// compute the statistics of the blocks and append them to the index in order
+	index.cascade_begin.clear();
+	index.slot_cascade.clear();
+	index.slot_node.clear();
+	index.edge_begin.clear();
+	index.edge_target.clear();
+	stats = CascadeStats();
+
+	for (int j = 0; j < n; j++) {
+		int i = to_append.pop();
+		auto t = chrono::high_resolution_clock::now();
+		cascade_statistics(blocks[i], index.slot_node.size(), stats);
+		append_block(index, blocks[i]);
+		blocks[i] = CascadeBlock();
+		append_seconds += seconds_since(t);
+	}
+
+	for (thread& stage : stages) {
+		stage.join();
+	}
+
+	auto t = chrono::high_resolution_clock::now();
+	finish_cascade_index(index);
+	double finish_seconds = seconds_since(t);
+
+	// add the nodes seen by each parser to the set of all nodes in all the cascades
+	for (set<int>& nodes : parser_nodes) {
+		V.insert(nodes.begin(), nodes.end());
+	}
+
+	int forests = 0, cyclic = 0, largest_bound = 0;
+	for (int c = 0; c < n; c++) {
+		forests += stats.forest[c];
+		cyclic += !stats.acyclic[c];
+	}
+	for (int bound : stats.reach_bound) {
+		largest_bound = max(largest_bound, bound);
+	}
+
+	if (!PARAM_REPRODUCIBLE) {
+		cout << endl << "PIPELINE STAGES (BUSY SEC): READ " << read_seconds << ", PARSE "
+			<< *max_element(parse_seconds.begin(), parse_seconds.end()) << " (SLOWEST OF " << parsers
+			<< " THREADS), FLATTEN " << flatten_seconds << ", STATISTICS " << append_seconds
+			<< ", NUMBERING " << finish_seconds << endl;
+	}
+	cout << endl << "FOREST CASCADES: " << forests << ", CASCADES WITH CYCLES: " << cyclic
+		<< ", LARGEST REACH BOUND: " << largest_bound << endl;
+	if (!PARAM_REPRODUCIBLE) {
+		cout << "LOAD TIME (SEC): " << seconds_since(start) << endl;
+	}
+
+}
+
+
+
+
+/*
+Function: prefetch_frontier
+Input: cascade index, pointer to ints, pointer to chars, vector of ints, int
+Output: none
+
+Description: Issues prefetches for the entries of a breadth-first search queue
+ahead of position head, along the chain of loads the search will make for
+them: the adjacency offsets of the entry prefetch_distance ahead, the
+adjacency list of the entry half as far ahead (whose offsets were prefetched
+earlier), and the search stamps and coverage flags of the targets of the
+entry a quarter as far ahead (whose list was prefetched earlier). stamp or
+covered may be NULL if the search does not read them. Entries not yet in the
+queue when their turn comes are skipped. Does nothing if prefetch_distance
+is zero.
+*/
+inline void prefetch_frontier(CascadeIndex& index, const int* stamp, const char* covered, vector<int>& queue, int head)
+{
+
+	int distance = prefetch_distance;
+
+	if (distance == 0) {
+		return;
+	}
+
+	int size = queue.size();
+
+	if (head + distance < size) {
+		__builtin_prefetch(&index.edge_begin[queue[head + distance]]);
+	}
+
+	if (head + distance / 2 < size) {
+		__builtin_prefetch(index.edge_target.data() + index.edge_begin[queue[head + distance / 2]]);
+	}
+
+	int near = head + max(1, distance / 4);
+
+	if (near < size) {
+
+		int u = queue[near];
+
+		for (int e = index.edge_begin[u]; e < index.edge_begin[u + 1]; e++) {
+
+			int v = index.edge_target[e];
+
+			if (stamp != NULL) {
+				__builtin_prefetch(&stamp[v], 1);
+			}
+			if (covered != NULL) {
+				__builtin_prefetch(&covered[v]);
+			}
+
+		}
+
+	}
+
+}
+
+
+
+
+/*
+Function: prefetch_frontier
+Input: storage, pointer to ints, pointer to chars, vector of ints, int
+Output: none
+
+Description: Overload for the storage backends other than the cascade index,
+which do not prefetch.
+*/
+template <class Store>
+inline void prefetch_frontier(Store&, const int*, const char*, vector<int>&, int)
+{
+}
+
+
+
+
+/*
+Function: collect_reach
+Input: storage, int, traversal scratch, vector of ints
+Output: none
+
+Description: Replaces the contents of reach with the slots reachable from the
+given slot (including the slot itself) using breadth-first search.
+*/
+template <class Store>
+void collect_reach(Store& index, int slot, TraversalScratch& scratch, vector<int>& reach)
+{
+
+	int stamp = ++scratch.current;
+
+	// the reach list doubles as the breadth-first search queue
+	reach.clear();
+	reach.push_back(slot);
+	scratch.stamp[slot] = stamp;
+
+	for (int head = 0; head < (int)reach.size(); head++) {
+
+		prefetch_frontier(index, scratch.stamp.data(), NULL, reach, head);
+
+		int u = reach[head];
+
+		for (int v : index.neighbors(u)) {
+
+			if (scratch.stamp[v] != stamp) {
+				scratch.stamp[v] = stamp;
+				reach.push_back(v);
+			}
+
+		}
+
+	}
+
+}
+
+
+
+
+/*
+Function: count_uncovered_reach
+Input: storage, vector of chars, int, traversal scratch
+Output: int
+
+Description: Counts the slots reachable from the given slot that are not marked
+covered. Covered slots are never entered: covered is the set of slots reachable
+from a seed set, so anything reachable through a covered slot is covered too.
+*/
+template <class Store>
+int count_uncovered_reach(Store& index, FlatFlags& covered, int slot, TraversalScratch& scratch)
+{
+
+	// a covered slot adds nothing
+	if (covered[slot]) {
+		return 0;
+	}
+
+	int stamp = ++scratch.current;
+
+	scratch.queue.clear();
+	scratch.queue.push_back(slot);
+	scratch.stamp[slot] = stamp;
+
+	for (int head = 0; head < (int)scratch.queue.size(); head++) {
+
+		prefetch_frontier(index, scratch.stamp.data(), covered.data(), scratch.queue, head);
+
+		int u = scratch.queue[head];
+
+		for (int v : index.neighbors(u)) {
+
+			if (!covered[v] && scratch.stamp[v] != stamp) {
+				scratch.stamp[v] = stamp;
+				scratch.queue.push_back(v);
+			}
+
+		}
+
+	}
+
+	return scratch.queue.size();
+
+}
+
+
+
+
+/*
+Function: cover_reach
+Input: storage, vector of chars, int, traversal scratch
+Output: int
+
+Description: Marks every slot reachable from the given slot as covered and
+returns the number of slots that were not covered before.
+*/
+template <class Store>
+int cover_reach(Store& index, FlatFlags& covered, int slot, TraversalScratch& scratch)
+{
+
+	if (covered[slot]) {
+		return 0;
+	}
+
+	scratch.queue.clear();
+	scratch.queue.push_back(slot);
+	covered[slot] = 1;
+
+	for (int head = 0; head < (int)scratch.queue.size(); head++) {
+
+		prefetch_frontier(index, NULL, covered.data(), scratch.queue, head);
+
+		int u = scratch.queue[head];
+
+		for (int v : index.neighbors(u)) {
+
+			if (!covered[v]) {
+				covered[v] = 1;
+				scratch.queue.push_back(v);
+			}
+
+		}
+
+	}
+
+	return scratch.queue.size();
+
+}
+
+
+
+
+/*
+Function: marginal_gain
+Input: storage, vector of chars, int, traversal scratch
+Output: long long
+
+Description: Returns the increase in the total number of nodes reached over
+all cascades when the node with dense id d is added to the seed set whose
+reachable slots are marked in covered. Dividing by the number of cascades
+gives the change in the influence computed by calculate_influence.
+*/
+template <class Store>
+long long marginal_gain(Store& index, FlatFlags& covered, int d, TraversalScratch& scratch)
+{
+
+	IdRange occurrences = index.occurrences(d);
+
+	// a node reaches itself in every cascade it does not appear in (see
+	// reachable_from)
+	long long gain = index.num_cascades() - (occurrences.end() - occurrences.begin());
+
+	for (int slot : occurrences) {
+		gain += count_uncovered_reach(index, covered, slot, scratch);
+	}
+
+	return gain;
+
+}
+
+
+
+
+/*
+Function: add_seed
+Input: storage, vector of chars, int, traversal scratch
+Output: long long
+
+Description: Adds the node with dense id d to the seed set whose reachable slots
+are marked in covered, and returns its marginal gain (see marginal_gain).
+*/
+template <class Store>
+long long add_seed(Store& index, FlatFlags& covered, int d, TraversalScratch& scratch)
+{
+
+	IdRange occurrences = index.occurrences(d);
+
+	long long gain = index.num_cascades() - (occurrences.end() - occurrences.begin());
+
+	for (int slot : occurrences) {
+		gain += cover_reach(index, covered, slot, scratch);
+	}
+
+	return gain;
+
+}
+
+
+
+
+/*
+Function: print_result
+Input: set of integers, double, time point
+Output: none
+
+Description: Prints the seed set found by a variant of the greedy algorithm,
+its influence, and the time since start, in the same format as main().
+*/
+void print_result(set<int>& S, double influence, chrono::high_resolution_clock::time_point start)
+{
+
+	cout << endl << "GREEDY ALGORITHM FINISHED!" << endl;
+
+	cout << endl << "APPROXIMATELY OPTIMAL SET (SIZE " << to_string(S.size()) << "): ";
+	print_set(S);
+	cout << endl;
+
+	cout << endl << "INFLUENCE OF APPROX. OPTIMAL SET (NUMBER OF NODES): " << to_string(influence) << endl;
+
+	auto stop = chrono::high_resolution_clock::now();
+
+	auto duration = chrono::duration_cast<chrono::milliseconds>(stop - start);
+
+	if (!PARAM_REPRODUCIBLE) {
+		cout << endl << "TIME (SEC): " << duration.count() / 1000.0 << endl << endl;
+	}
+
+}
+
+
+
+
+/*
+Function: attribute_seeds
+Input: vector of maps, vector of strings, set of ints
+Output: none
+
+Description: Explains the reach of the seed set S. Every seed's reach is
+collected once, and every slot counts how many seeds reach it; a single pass
+over these coverage counters then splits the slots of each cascade into those
+reached by exactly one seed (the seed's exclusive reach, which is what the
+cascade would lose without the seed) and those reached by several seeds
+(shared). A seed that does not appear in a cascade reaches only itself there,
+exclusively. Writes one row per cascade to ATTRIBUTION_FILE (the cascade
+name, the exclusive reach of each seed, the shared reach, and the total), and
+prints the average per cascade of each column.
+*/
+void attribute_seeds(vector<map<int, vector<int> > >& cascades, vector<string>& cascade_names, set<int>& S)
+{
+
+	CascadeIndex index;
+	build_cascade_index(cascades, index);
+
+	TraversalScratch scratch;
+	prepare_scratch(index, scratch);
+
+	vector<int> seeds(S.begin(), S.end());
+	int k = seeds.size();
+
+	// slot -> number of seeds reaching it, and the last seed that did
+	FlatInts coverage(index.slot_node.size(), 0);
+	FlatInts owner(index.slot_node.size(), -1);
+
+	// seed -> dense id of its node (-1 if it is in no cascade)
+	vector<int> seed_node(k, -1);
+
+	vector<int> reach;
+	for (int i = 0; i < k; i++) {
+
+		auto found = lower_bound(index.labels.begin(), index.labels.end(), seeds[i]);
+		if (found == index.labels.end() || *found != seeds[i]) {
+			continue;
+		}
+		int d = seed_node[i] = found - index.labels.begin();
+
+		// a node appears at most once per cascade, so the searches of one
+		// seed never overlap
+		for (int o = index.occurrence_begin[d]; o < index.occurrence_begin[d + 1]; o++) {
+			collect_reach(index, index.occurrence_slot[o], scratch, reach);
+			for (int v : reach) {
+				coverage[v]++;
+				owner[v] = i;
+			}
+		}
+
+	}
+
+	ofstream csv(ATTRIBUTION_FILE.c_str());
+	csv << "cascade";
+	for (int seed : seeds) {
+		csv << "," << seed;
+	}
+	csv << ",shared,total\n";
+
+	// next occurrence of each seed, to tell the cascades it is not in
+	vector<int> next_occurrence(k, 0);
+	for (int i = 0; i < k; i++) {
+		next_occurrence[i] = seed_node[i] == -1 ? 0 : index.occurrence_begin[seed_node[i]];
+	}
+
+	vector<long long> exclusive(k);
+	vector<long long> total_exclusive(k, 0);
+	vector<int> appears_in(k, 0);
+	long long total_shared = 0;
+
+	for (int c = 0; c < (int)cascades.size(); c++) {
+
+		exclusive.assign(k, 0);
+		long long shared = 0;
+
+		for (int slot = index.cascade_begin[c]; slot < index.cascade_begin[c + 1]; slot++) {
+			if (coverage[slot] == 1) {
+				exclusive[owner[slot]]++;
+			}
+			else if (coverage[slot] > 1) {
+				shared++;
+			}
+		}
+
+		for (int i = 0; i < k; i++) {
+			int d = seed_node[i];
+			if (d != -1 && next_occurrence[i] < index.occurrence_begin[d + 1]
+				&& index.slot_cascade[index.occurrence_slot[next_occurrence[i]]] == c) {
+				next_occurrence[i]++;
+				appears_in[i]++;
+			}
+			else {
+				exclusive[i] = 1;
+			}
+		}
+
+		long long total = shared;
+		csv << cascade_names[c];
+		for (int i = 0; i < k; i++) {
+			csv << "," << exclusive[i];
+			total += exclusive[i];
+			total_exclusive[i] += exclusive[i];
+		}
+		csv << "," << shared << "," << total << "\n";
+
+		total_shared += shared;
+
+	}
+
+	int n = max((int)cascades.size(), 1);
+
+	cout << "ATTRIBUTION (AVERAGE REACH PER CASCADE; EXCLUSIVE REACH IS THE INFLUENCE LOST WITHOUT THE SEED):" << endl;
+	for (int i = 0; i < k; i++) {
+		cout << "SEED " << to_string(seeds[i]) << ": EXCLUSIVE " << to_string((double)total_exclusive[i] / n)
+			<< " (APPEARS IN " << to_string(appears_in[i]) << " CASCADES)" << endl;
+	}
+	cout << "SHARED BY SEVERAL SEEDS: " << to_string((double)total_shared / n) << endl;
+	cout << "TABLE WRITTEN TO " << ATTRIBUTION_FILE << endl << endl;
+
+}
+
+
+
+
+/*
+Structure: Topic
+Description: State of the greedy algorithm for one topic (a subset of the
+			 cascades) in MODE_TOPICS. Each topic keeps its own coverage,
+			 seed set and lazy queue of marginal gains.
+*/
+struct Topic
+{
+
+	// name of the topic as given in the topic file
+	string name;
+
+	// cascade -> whether the cascade belongs to the topic, and the number of
+	// cascades that do
+	vector<char> member;
+	int num_cascades = 0;
+
+	// slot -> whether the slot is reachable from the seed set of the topic
+	FlatFlags covered;
+
+	// seed set of the topic and the total number of nodes it reaches over the
+	// cascades of the topic
+	set<int> S;
+	long long total = 0;
+
+	// lazy queue of (upper bound on marginal gain, negated dense node id);
+	// ties on the gain go to the smaller node, as in main()
+	priority_queue<pair<long long, int> > gains;
+
+	// dense node id -> iteration in which the bound in the queue was computed
+	vector<int> evaluated_at;
+
+};
+
+
+
+
+/*
+Function: read_topics
+Input: cascade index, vector of strings, vector of topics
+Output: none
+
+Description: Reads TOPIC_FILE. Each non-comment line holds a topic name followed
+by the file names of the cascades in the topic (e.g. "sports cascade_1.txt
+cascade_3.txt"). File names are matched against the names of the files read
+from CASCADE_DIRECTORY. Topics without any known cascade are skipped.
+*/
+void read_topics(CascadeIndex& index, vector<string>& cascade_names, vector<Topic>& topics)
+{
+
+	// map each cascade file name (without its directory) to its cascade
+	map<string, int> cascade_of_name;
+	for (int c = 0; c < (int)cascade_names.size(); c++) {
+		cascade_of_name[filesystem::path(cascade_names[c]).filename().string()] = c;
+	}
+
+	ifstream infile(TOPIC_FILE.c_str());
+
+	string line;
+	while (getline(infile, line)) {
+
+		// skip empty and comment lines
+		if (line == "" || line.at(0) == POUND || line.at(0) == PERCENT) {
+			continue;
+		}
+
+		istringstream iss(line);
+
+		Topic topic;
+		iss >> topic.name;
+		topic.member.assign(cascade_names.size(), 0);
+
+		string file_name;
+		while (iss >> file_name) {
+
+			auto found = cascade_of_name.find(filesystem::path(file_name).filename().string());
+
+			if (found == cascade_of_name.end()) {
+				cout << endl << "WARNING: TOPIC " << topic.name << " LISTS UNKNOWN CASCADE " << file_name << endl;
+			}
+			else if (!topic.member[found->second]) {
+				topic.member[found->second] = 1;
+				topic.num_cascades++;
+			}
+
+		}
+
+		if (topic.num_cascades == 0) {
+			cout << endl << "WARNING: TOPIC " << topic.name << " HAS NO CASCADES AND IS SKIPPED" << endl;
+			continue;
+		}
+
+		topic.covered.assign(index.slot_node.size(), 0);
+		topic.evaluated_at.assign(index.labels.size(), -1);
+		topics.push_back(topic);
+
+	}
+
+}
+
+
+
+
+/*
+Function: evaluate_topic_requests
+Input: cascade index, vector of topics, map from ints to vectors of ints, int,
+	   traversal scratch, two long longs
+Output: none
+
+Description: Given requests mapping dense node ids to the topics that need the
+node's marginal gain in iteration iter, computes the reach of each requested
+node once per cascade it appears in and counts it against the coverage of
+every requesting topic that contains the cascade. Pushes the exact gains onto
+the topics' queues. Adds the number of traversals performed to traversals and
+the number a separate run per topic would have performed to unshared.
+*/
+void evaluate_topic_requests(CascadeIndex& index, vector<Topic>& topics, map<int, vector<int> >& requests,
+	int iter, TraversalScratch& scratch, long long& traversals, long long& unshared)
+{
+
+	vector<int> reach;
+	vector<long long> gain;
+	vector<int> present;
+
+	for (auto& request : requests) {
+
+		int d = request.first;
+		vector<int>& requesting = request.second;
+
+		gain.assign(requesting.size(), 0);
+		present.assign(requesting.size(), 0);
+
+		// for each cascade the node appears in, do
+		for (int o = index.occurrence_begin[d]; o < index.occurrence_begin[d + 1]; o++) {
+
+			int slot = index.occurrence_slot[o];
+			int c = index.slot_cascade[slot];
+
+			// traverse the cascade only if some requesting topic contains it
+			bool needed = false;
+			for (int t : requesting) {
+				needed = needed || topics[t].member[c];
+			}
+			if (!needed) {
+				continue;
+			}
+
+			collect_reach(index, slot, scratch, reach);
+			traversals++;
+
+			// count the reach against the coverage of each requesting topic
+			for (int j = 0; j < (int)requesting.size(); j++) {
+
+				Topic& topic = topics[requesting[j]];
+
+				if (!topic.member[c]) {
+					continue;
+				}
+
+				present[j]++;
+				unshared++;
+
+				if (!topic.covered[slot]) {
+					for (int v : reach) {
+						gain[j] += !topic.covered[v];
+					}
+				}
+
+			}
+
+		}
+
+		// a node reaches itself in every cascade of the topic it does not
+		// appear in (see reachable_from)
+		for (int j = 0; j < (int)requesting.size(); j++) {
+			Topic& topic = topics[requesting[j]];
+			gain[j] += topic.num_cascades - present[j];
+			topic.gains.push(make_pair(gain[j], -d));
+			topic.evaluated_at[d] = iter;
+		}
+
+	}
+
+}
+
+
+
+
+/*
+Function: run_topic_greedy
+Input: vector of maps, vector of strings
+Output: none
+
+Description: Runs the greedy algorithm once for every topic in TOPIC_FILE,
+all topics at the same time. Each topic keeps its own coverage and lazy queue
+of marginal gains (valid upper bounds because influence is submodular). In
+each round every topic whose top entry is stale asks for that node, and each
+requested node is traversed once per cascade for all topics that asked for
+it, so the traversal work grows with the corpus rather than with the corpus
+times the number of topics. Selects, for each topic, the same seed set that a
+separate run over the topic's cascades would select.
+*/
+void run_topic_greedy(vector<map<int, vector<int> > >& cascades, vector<string>& cascade_names)
+{
+
+	CascadeIndex index;
+	build_cascade_index(cascades, index);
+
+	vector<Topic> topics;
+	read_topics(index, cascade_names, topics);
+
+	cout << endl << "RUNNING GREEDY ALGORITHM FOR " << to_string(topics.size()) << " TOPICS..." << endl;
+
+	auto start = chrono::high_resolution_clock::now();
+
+	TraversalScratch scratch;
+	prepare_scratch(index, scratch);
+
+	long long traversals = 0;
+	long long unshared = 0;
+
+	// in the first iteration every topic needs the gain of every node that
+	// appears in one of its cascades
+	map<int, vector<int> > requests;
+	for (int t = 0; t < (int)topics.size(); t++) {
+		for (int c = 0; c < (int)cascades.size(); c++) {
+
+			if (!topics[t].member[c]) {
+				continue;
+			}
+
+			for (int slot = index.cascade_begin[c]; slot < index.cascade_begin[c + 1]; slot++) {
+				vector<int>& requesting = requests[index.slot_node[slot]];
+				if (requesting.empty() || requesting.back() != t) {
+					requesting.push_back(t);
+				}
+			}
+
+		}
+	}
+	evaluate_topic_requests(index, topics, requests, 0, scratch, traversals, unshared);
+
+	// for K iterations corresponding to the K nodes to be selected, do
+	for (int iter = 0; iter < PARAM_K; iter++) {
+
+		// until every topic has selected its node for this iteration, do
+		while (true) {
+
+			requests.clear();
+
+			for (int t = 0; t < (int)topics.size(); t++) {
+
+				Topic& topic = topics[t];
+
+				// skip topics that already selected a node this iteration or
+				// that have run out of nodes
+				if ((int)topic.S.size() > iter || topic.gains.empty()) {
+					continue;
+				}
+
+				pair<long long, int> top = topic.gains.top();
+				int d = -top.second;
+				topic.gains.pop();
+
+				// a stale bound has to be recomputed against the current coverage
+				if (topic.evaluated_at[d] != iter) {
+					requests[d].push_back(t);
+					continue;
+				}
+
+				// an up-to-date gain on top of the queue beats every other
+				// node's upper bound, so add the node to the topic's seed set
+				topic.S.insert(index.labels[d]);
+				topic.total += top.first;
+
+				for (int o = index.occurrence_begin[d]; o < index.occurrence_begin[d + 1]; o++) {
+					int slot = index.occurrence_slot[o];
+					if (topic.member[index.slot_cascade[slot]]) {
+						cover_reach(index, topic.covered, slot, scratch);
+					}
+				}
+
+			}
+
+			if (requests.empty()) {
+				break;
+			}
+
+			evaluate_topic_requests(index, topics, requests, iter, scratch, traversals, unshared);
+
+		}
+
+	}
+
+	cout << endl << "GREEDY ALGORITHM FINISHED!" << endl;
+
+	// print the seed set and influence of each topic
+	for (Topic& topic : topics) {
+
+		cout << endl << "TOPIC " << topic.name << " (" << to_string(topic.num_cascades) << " CASCADES)" << endl;
+
+		cout << "APPROXIMATELY OPTIMAL SET (SIZE " << to_string(topic.S.size()) << "): ";
+		print_set(topic.S);
+		cout << endl;
+
+		cout << "INFLUENCE OF APPROX. OPTIMAL SET (NUMBER OF NODES): " << to_string((double)topic.total / topic.num_cascades) << endl;
+
+	}
+
+	// print how much traversal work sharing the cascades saved
+	cout << endl << "REACH TRAVERSALS (SHARED ACROSS TOPICS): " << to_string(traversals) << endl;
+	cout << endl << "REACH TRAVERSALS IF EACH TOPIC RAN SEPARATELY: " << to_string(unshared) << endl;
+
+	auto stop = chrono::high_resolution_clock::now();
+
+	auto duration = chrono::duration_cast<chrono::milliseconds>(stop - start);
+
+	if (!PARAM_REPRODUCIBLE) {
+		cout << endl << "TIME (SEC): " << duration.count() / 1000.0 << endl << endl;
+	}
+
+}
+
+
+
+
+
+/*
+Structure: CascadeReader
+Description: Pull-based reader of a stream of cascades from a file, a named
+			 pipe, or standard input. Each call to next() yields one cascade,
+			 so a simulator can write cascades into a pipe while the program
+			 consumes them, without a directory of files in between. Cascades
+			 are written as edgelists in the same format as the cascade files
+			 (parsed with parse_edge_line) and are separated by empty lines;
+			 a cascade without edges can be written as a comment line. The
+			 reader holds at most PARAM_READ_BUFFER_KB of unread input (more
+			 only if a single line is longer), so a writer that gets ahead is
+			 held back by the pipe instead of filling memory. If
+			 PARAM_STREAM_FOLLOW is set, the end of the input is treated like
+			 a file that is still growing: the reader waits for more input and
+			 only gives up after PARAM_STREAM_IDLE_SEC seconds without any.
+*/
+struct CascadeReader
+{
+
+	int fd = -1;
+
+	// unread input is buffer[begin, end)
+	vector<char> buffer;
+	size_t begin = 0;
+	size_t end = 0;
+
+	CascadeReader(string path)
+	{
+		fd = path == "/dev/stdin" ? 0 : open(path.c_str(), O_RDONLY);
+		buffer.resize(max(1, PARAM_READ_BUFFER_KB) << 10);
+	}
+
+	~CascadeReader()
+	{
+		if (fd > 0) {
+			close(fd);
+		}
+	}
+
+	CascadeReader(const CascadeReader&) = delete;
+	CascadeReader& operator=(const CascadeReader&) = delete;
+
+	// reads more input into the buffer; returns false once no more will come
+	bool fill()
+	{
+
+		if (fd == -1) {
+			return false;
+		}
+
+		// keep the unread part, and grow the buffer only for a line that fills it
+		if (begin > 0) {
+			memmove(buffer.data(), buffer.data() + begin, end - begin);
+			end -= begin;
+			begin = 0;
+		}
+		if (end == buffer.size()) {
+			buffer.resize(buffer.size() * 2);
+		}
+
+		auto idle_since = chrono::steady_clock::now();
+
+		while (true) {
+
+			ssize_t n = read(fd, buffer.data() + end, buffer.size() - end);
+
+			if (n > 0) {
+				end += n;
+				return true;
+			}
+			if (n < 0 && errno == EINTR) {
+				continue;
+			}
+
+			bool idle = chrono::steady_clock::now() - idle_since > chrono::seconds(PARAM_STREAM_IDLE_SEC);
+
+			if (n < 0 || !PARAM_STREAM_FOLLOW || idle) {
+				return false;
+			}
+
+			// wait for the writer to append more input
+			this_thread::sleep_for(chrono::milliseconds(100));
+
+		}
+
+	}
+
+	// points line and line_end at the next line (without its line break),
+	// which stays valid until the next call; returns false at the end of input
+	bool next_line(const char*& line, const char*& line_end)
+	{
+
+		while (true) {
+
+			const char* found = (const char*)memchr(buffer.data() + begin, '\n', end - begin);
+
+			if (found != NULL) {
+				line = buffer.data() + begin;
+				line_end = found;
+				begin = found - buffer.data() + 1;
+				return true;
+			}
+
+			if (!fill()) {
+
+				// whatever is left is the last line
+				if (begin == end) {
+					return false;
+				}
+
+				line = buffer.data() + begin;
+				line_end = buffer.data() + end;
+				begin = end;
+				return true;
+
+			}
+
+		}
+
+	}
+
+	// replaces A with the next cascade of the stream; returns false once the
+	// stream is exhausted
+	bool next(map<int, vector<int> >& A)
+	{
+
+		A.clear();
+
+		bool any_line = false;
+		const char* line;
+		const char* line_end;
+
+		while (next_line(line, line_end)) {
+
+			if (line_end > line && line_end[-1] == '\r') {
+				line_end--;
+			}
+
+			// an empty line ends the cascade, unless nothing has been read yet
+			if (line == line_end) {
+				if (any_line) {
+					return true;
+				}
+				continue;
+			}
+
+			any_line = true;
+
+			int from;
+			int to;
+			if (parse_edge_line(line, line_end, from, to)) {
+				A[from].push_back(to);
+			}
+
+		}
+
+		return any_line;
+
+	}
+
+};
+
+
+
+
+/*
+Function: read_cascade_stream
+Input: set of ints, vector of maps, vector of strings
+Output: none
+
+Description: Same as get_cascade_vector, but reads the cascades from the
+stream at STREAM_PATH with a CascadeReader. The i-th cascade of the stream
+is named "stream_i".
+*/
+void read_cascade_stream(set<int>& V, vector<map<int, vector<int> > >& cascades, vector<string>& cascade_names)
+{
+
+	CascadeReader reader(STREAM_PATH);
+
+	map<int, vector<int> > A;
+	while (reader.next(A)) {
+
+		for (auto& entry : A) {
+			V.insert(entry.first);
+			V.insert(entry.second.begin(), entry.second.end());
+		}
+
+		cascade_names.push_back("stream_" + to_string(cascades.size()));
+		cascades.push_back(A);
+
+	}
+
+}
+
+
+
+
+/*
+Structure: Sieve
+Description: One threshold of the sieve-streaming algorithm of Badanidiyuru et
+			 al. (2014) in MODE_STREAMING. The sieve guesses that the optimal
+			 influence is threshold and greedily keeps every node whose
+			 marginal gain is large enough for that guess.
+*/
+struct Sieve
+{
+
+	// guess of the optimal influence
+	double threshold;
+
+	// seed set of the sieve, in selection order
+	vector<int> S;
+
+	// reservoir cascade -> slots reachable from S in that cascade, and the
+	// number of nodes S reaches there (the covered slots plus one for every
+	// seed outside the cascade)
+	vector<FlatFlags> covered;
+	vector<int> reached;
+
+	// total number of nodes S reaches over the reservoir, the sum of reached
+	long long value = 0;
+
+};
+
+
+
+
+/*
+Function: local_slot
+Input: cascade index, int
+Output: int
+
+Description: Given the index of a single cascade and a node label, returns the
+slot of the node in the cascade or -1 if the node does not appear in it.
+*/
+int local_slot(CascadeIndex& index, int label)
+{
+
+	auto found = lower_bound(index.labels.begin(), index.labels.end(), label);
+
+	if (found == index.labels.end() || *found != label) {
+		return -1;
+	}
+
+	// with a single cascade, the slots are the nodes in ascending order
+	return found - index.labels.begin();
+
+}
+
+
+
+
+/*
+Function: reservoir_cascades
+Input: map from ints to vectors of ints, int
+Output: vector of ints
+
+Description: Returns the reservoir cascades the node u appears in (none if u
+is in no reservoir cascade), without adding an entry for u to the map.
+*/
+const vector<int>& reservoir_cascades(map<int, vector<int> >& reservoir_of_node, int u)
+{
+
+	static const vector<int> none;
+
+	auto found = reservoir_of_node.find(u);
+
+	return found == reservoir_of_node.end() ? none : found->second;
+
+}
+
+
+
+
+/*
+Function: sieve_gain
+Input: sieve, vector of cascade indices, vector of traversal scratch, map from
+	   ints to vectors of ints, int
+Output: long long
+
+Description: Returns the increase in the total number of nodes reached over the
+reservoir when the node u is added to the seed set of the sieve.
+*/
+long long sieve_gain(Sieve& sieve, vector<CascadeIndex>& reservoir, vector<TraversalScratch>& scratch,
+	map<int, vector<int> >& reservoir_of_node, int u)
+{
+
+	if (find(sieve.S.begin(), sieve.S.end(), u) != sieve.S.end()) {
+		return 0;
+	}
+
+	const vector<int>& containing = reservoir_cascades(reservoir_of_node, u);
+
+	// u reaches itself in every reservoir cascade it does not appear in
+	long long gain = reservoir.size() - containing.size();
+
+	for (int r : containing) {
+		gain += count_uncovered_reach(reservoir[r], sieve.covered[r], local_slot(reservoir[r], u), scratch[r]);
+	}
+
+	return gain;
+
+}
+
+
+
+
+/*
+Function: singleton_gain
+Input: vector of cascade indices, vector of traversal scratch, map from ints to
+	   vectors of ints, int
+Output: long long
+
+Description: Returns the total number of nodes the node u alone reaches over
+the reservoir (sieve_gain for an empty seed set).
+*/
+long long singleton_gain(vector<CascadeIndex>& reservoir, vector<TraversalScratch>& scratch,
+	map<int, vector<int> >& reservoir_of_node, int u)
+{
+
+	const vector<int>& containing = reservoir_cascades(reservoir_of_node, u);
+
+	long long gain = reservoir.size() - containing.size();
+
+	for (int r : containing) {
+		collect_reach(reservoir[r], local_slot(reservoir[r], u), scratch[r], scratch[r].queue);
+		gain += scratch[r].queue.size();
+	}
+
+	return gain;
+
+}
+
+
+
+
+/*
+Function: add_sieve_seed
+Input: sieve, vector of cascade indices, vector of traversal scratch, map from
+	   ints to vectors of ints, int
+Output: none
+
+Description: Adds the node u to the seed set of the sieve and updates its
+coverage, reached counts and value.
+*/
+void add_sieve_seed(Sieve& sieve, vector<CascadeIndex>& reservoir, vector<TraversalScratch>& scratch,
+	map<int, vector<int> >& reservoir_of_node, int u)
+{
+
+	sieve.S.push_back(u);
+
+	// u reaches itself in the cascades it is not in, and its reach in the others
+	for (int q = 0; q < (int)reservoir.size(); q++) {
+		sieve.reached[q]++;
+	}
+	sieve.value += reservoir.size();
+
+	for (int q : reservoir_cascades(reservoir_of_node, u)) {
+		int gain = cover_reach(reservoir[q], sieve.covered[q], local_slot(reservoir[q], u), scratch[q]) - 1;
+		sieve.reached[q] += gain;
+		sieve.value += gain;
+	}
+
+}
+
+
+
+
+/*
+Function: reset_sieve_cascade
+Input: sieve, vector of cascade indices, vector of traversal scratch, int
+Output: none
+
+Description: Recomputes the coverage of the sieve's seed set in reservoir
+cascade r, after that cascade has been added or replaced, and replaces the
+cascade's old share of the sieve's value with the new one.
+*/
+void reset_sieve_cascade(Sieve& sieve, vector<CascadeIndex>& reservoir, vector<TraversalScratch>& scratch, int r)
+{
+
+	if ((int)sieve.covered.size() <= r) {
+		sieve.covered.resize(r + 1);
+		sieve.reached.resize(r + 1, 0);
+	}
+
+	sieve.value -= sieve.reached[r];
+
+	sieve.covered[r].assign(reservoir[r].slot_node.size(), 0);
+	sieve.reached[r] = 0;
+
+	for (int s : sieve.S) {
+		int slot = local_slot(reservoir[r], s);
+		if (slot == -1) {
+			sieve.reached[r]++;
+		}
+		else {
+			sieve.reached[r] += cover_reach(reservoir[r], sieve.covered[r], slot, scratch[r]);
+		}
+	}
+
+	sieve.value += sieve.reached[r];
+
+}
+
+
+
+
+/*
+Function: run_streaming
+Input: none
+Output: none
+
+Description: Selects seeds from a stream of cascades read from STREAM_PATH (a
+file, a named pipe, or /dev/stdin) in a single pass. The influence of a set is
+estimated on a uniform reservoir sample of PARAM_STREAM_RESERVOIR cascades, so
+memory does not grow with the number of cascades in the stream. Every node of
+every arriving cascade is offered to the sieves of the sieve-streaming
+algorithm (thresholds (1 + PARAM_STREAM_EPSILON)^i between the largest
+single-node influence m and 2 * PARAM_K * m), and the best sieve is a
+(1/2 - epsilon)-approximate seed set with respect to the reservoir estimate.
+Prints the current best set every PARAM_STREAM_REPORT cascades and the
+processing cost per cascade at the end.
+*/
+void run_streaming()
+{
+
+	cout << endl << "READING CASCADE STREAM..." << endl;
+
+	CascadeReader reader(STREAM_PATH);
+
+	// reservoir of cascades the influence is estimated on, one traversal
+	// scratch per reservoir cascade, and the reservoir cascades each node
+	// appears in
+	vector<CascadeIndex> reservoir;
+	vector<TraversalScratch> scratch;
+	map<int, vector<int> > reservoir_of_node;
+
+	// sieves by the exponent i of their threshold (1 + epsilon)^i
+	map<int, Sieve> sieves;
+	double max_singleton = 0.0;
+	double log_base = log(1.0 + PARAM_STREAM_EPSILON);
+
+	long long num_cascades = 0;
+	double total_micros = 0.0;
+	double max_micros = 0.0;
+
+	map<int, vector<int> > A;
+	vector<map<int, vector<int> > > single(1);
+
+	// for each cascade in the stream, do
+	while (reader.next(A)) {
+
+		auto start = chrono::high_resolution_clock::now();
+
+		num_cascades++;
+
+		CascadeIndex arriving;
+		single[0] = A;
+		build_cascade_index(single, arriving);
+
+		// keep the cascade in the reservoir with probability R / n
+		int r = -1;
+		if (reservoir.size() < PARAM_STREAM_RESERVOIR) {
+			r = reservoir.size();
+			reservoir.push_back(CascadeIndex());
+			scratch.push_back(TraversalScratch());
+		}
+		else {
+			long long j = CounterRng(PARAM_RANDOM_SEED, num_cascades - 1, 0).below(num_cascades);
+			if (j < PARAM_STREAM_RESERVOIR) {
+				r = j;
+			}
+		}
+
+		if (r != -1) {
+
+			// forget the nodes of the cascade being replaced
+			for (int label : reservoir[r].labels) {
+				vector<int>& containing = reservoir_of_node[label];
+				containing.erase(find(containing.begin(), containing.end(), r));
+				if (containing.empty()) {
+					reservoir_of_node.erase(label);
+				}
+			}
+
+			reservoir[r] = arriving;
+			prepare_scratch(reservoir[r], scratch[r]);
+
+			for (int label : reservoir[r].labels) {
+				reservoir_of_node[label].push_back(r);
+			}
+
+			for (auto& entry : sieves) {
+				reset_sieve_cascade(entry.second, reservoir, scratch, r);
+			}
+
+		}
+
+		// offer every node of the arriving cascade to the sieves
+		for (int u : arriving.labels) {
+
+			// the influence of u alone bounds the thresholds worth keeping
+			double singleton = (double)singleton_gain(reservoir, scratch, reservoir_of_node, u) / reservoir.size();
+
+			if (singleton > max_singleton) {
+
+				max_singleton = singleton;
+
+				int low = ceil(log(max_singleton) / log_base - 1e-9);
+				int high = floor(log(2.0 * PARAM_K * max_singleton) / log_base + 1e-9);
+
+				// drop sieves whose guess is below the new lower bound
+				sieves.erase(sieves.begin(), sieves.lower_bound(low));
+
+				// start empty sieves for the new guesses
+				for (int i = low; i <= high; i++) {
+					if (sieves.find(i) == sieves.end()) {
+						Sieve& sieve = sieves[i];
+						sieve.threshold = pow(1.0 + PARAM_STREAM_EPSILON, i);
+						for (int q = 0; q < (int)reservoir.size(); q++) {
+							reset_sieve_cascade(sieve, reservoir, scratch, q);
+						}
+					}
+				}
+
+			}
+
+			for (auto& entry : sieves) {
+
+				Sieve& sieve = entry.second;
+
+				if (sieve.S.size() >= PARAM_K) {
+					continue;
+				}
+
+				// keep u if its gain is at least the sieve's share of what is
+				// still missing to half of the guessed optimum
+				double value = (double)sieve.value / reservoir.size();
+				double gain = (double)sieve_gain(sieve, reservoir, scratch, reservoir_of_node, u) / reservoir.size();
+
+				if (gain > 0 && gain >= (sieve.threshold / 2.0 - value) / (PARAM_K - sieve.S.size())) {
+					add_sieve_seed(sieve, reservoir, scratch, reservoir_of_node, u);
+				}
+
+			}
+
+		}
+
+		auto stop = chrono::high_resolution_clock::now();
+		double micros = chrono::duration_cast<chrono::nanoseconds>(stop - start).count() / 1000.0;
+		total_micros += micros;
+		max_micros = max(max_micros, micros);
+
+		if (num_cascades % PARAM_STREAM_REPORT == 0) {
+			Sieve* best = NULL;
+			long long best_value = -1;
+			for (auto& entry : sieves) {
+				long long value = entry.second.value;
+				if (value > best_value) {
+					best_value = value;
+					best = &entry.second;
+				}
+			}
+			set<int> S(best->S.begin(), best->S.end());
+			cout << endl << "CASCADES READ: " << to_string(num_cascades) << " CURRENT SET: ";
+			print_set(S);
+			cout << " ESTIMATED INFLUENCE: " << to_string((double)best_value / reservoir.size()) << endl;
+		}
+
+	}
+
+	cout << endl << "CASCADE STREAM FINISHED! NUMBER OF CASCADES: " << to_string(num_cascades) << endl;
+
+	if (num_cascades == 0) {
+		return;
+	}
+
+	// report the best sieve
+	Sieve* best = NULL;
+	long long best_value = -1;
+	for (auto& entry : sieves) {
+		long long value = entry.second.value;
+		if (value > best_value) {
+			best_value = value;
+			best = &entry.second;
+		}
+	}
+
+	set<int> S;
+	if (best != NULL) {
+		S.insert(best->S.begin(), best->S.end());
+	}
+
+	cout << endl << "APPROXIMATELY OPTIMAL SET (SIZE " << to_string(S.size()) << "): ";
+	print_set(S);
+	cout << endl;
+
+	cout << endl << "ESTIMATED INFLUENCE OF APPROX. OPTIMAL SET (NUMBER OF NODES, " << to_string(reservoir.size())
+		<< " RESERVOIR CASCADES): " << to_string(max(best_value, 0LL) / (double)reservoir.size()) << endl;
+
+	cout << endl << "SIEVES: " << to_string(sieves.size()) << endl;
+
+	if (!PARAM_REPRODUCIBLE) {
+		cout << endl << "PROCESSING TIME PER CASCADE (MICROSEC): AVERAGE " << to_string(total_micros / num_cascades)
+			<< " MAXIMUM " << to_string(max_micros) << endl << endl;
+	}
+
+}
+
+
+
+
+
+/*
+Function: bernstein_radius
+Input: double, double, long long, double
+Output: double
+
+Description: Returns the half-width of a confidence interval for the mean of n
+samples in [0, range] with the given sample variance that fails with
+probability at most delta (empirical Bernstein bound of Audibert, Munos and
+Szepesvari, 2009).
+Much tighter than Hoeffding's inequality when most samples are alike.
+*/
+double bernstein_radius(double range, double variance, long long n, double delta)
+{
+
+	double log_term = log(3.0 / delta);
+
+	return sqrt(2.0 * variance * log_term / n) + 3.0 * range * log_term / n;
+
+}
+
+
+
+
+/*
+Function: run_subsample_greedy
+Input: vector of maps
+Output: none
+
+Description: Runs the greedy algorithm, but in each iteration evaluates the
+candidates on a growing random sample of the cascades instead of on all of
+them. The sample starts at PARAM_SUBSAMPLE_INITIAL cascades and doubles until
+the lower confidence bound on the mean gain of the leading node exceeds the
+upper confidence bound of every other node (empirical Bernstein bounds, all
+holding together with probability PARAM_CONFIDENCE). When the gains are too close to separate,
+the sample grows to the whole corpus and the choice is exact. The chosen
+node's coverage is always updated on all cascades, so the reported influence
+is exact.
+*/
+void run_subsample_greedy(vector<map<int, vector<int> > >& cascades)
+{
+
+	CascadeIndex index;
+	build_cascade_index(cascades, index);
+
+	cout << endl << "RUNNING GREEDY ALGORITHM ON ADAPTIVE SAMPLES OF THE CASCADES..." << endl;
+
+	auto start = chrono::high_resolution_clock::now();
+
+	int num_cascades = cascades.size();
+	int num_nodes = index.labels.size();
+
+	TraversalScratch scratch;
+	prepare_scratch(index, scratch);
+
+	// the gain of a node in one cascade is at most the size of the largest
+	// cascade (and at least one if the node is outside the cascade)
+	double range = 1.0;
+	for (int c = 0; c < num_cascades; c++) {
+		range = max(range, (double)(index.cascade_begin[c + 1] - index.cascade_begin[c]));
+	}
+
+	// number of doublings of the sample, for the union bound
+	int rounds = 1;
+	for (long long n = PARAM_SUBSAMPLE_INITIAL; n < num_cascades; n *= 2) {
+		rounds++;
+	}
+
+	FlatFlags covered(index.slot_node.size(), 0);
+	vector<char> chosen(num_nodes, 0);
+	set<int> S;
+	long long total = 0;
+
+	vector<int> order(num_cascades);
+	vector<long long> gain_present(num_nodes);
+	vector<long long> square_present(num_nodes);
+	vector<int> present(num_nodes);
+
+	// (candidate, cascade) evaluations made, and made by the exact greedy
+	long long evaluated = 0;
+	long long full = 0;
+	vector<int> sample_sizes;
+
+	// for K iterations corresponding to the K nodes to be selected, do
+	for (int iter = 0; iter < PARAM_K && (int)S.size() < num_nodes; iter++) {
+
+		// draw a fresh random order of the cascades; the sample is a prefix of it
+		random_order(num_cascades, iter, order);
+
+		int candidates = num_nodes - S.size();
+		double delta = (1.0 - PARAM_CONFIDENCE) / ((double)candidates * rounds * PARAM_K);
+
+		fill(gain_present.begin(), gain_present.end(), 0);
+		fill(square_present.begin(), square_present.end(), 0);
+		fill(present.begin(), present.end(), 0);
+
+		int n = 0;
+		int leader = -1;
+
+		while (true) {
+
+			int next = min((long long)num_cascades, max((long long)PARAM_SUBSAMPLE_INITIAL, 2LL * n));
+
+			// add the gains of every candidate in the newly sampled cascades
+			for (int i = n; i < next; i++) {
+				int c = order[i];
+				for (int slot = index.cascade_begin[c]; slot < index.cascade_begin[c + 1]; slot++) {
+					int d = index.slot_node[slot];
+					if (!chosen[d]) {
+						long long gain = count_uncovered_reach(index, covered, slot, scratch);
+						gain_present[d] += gain;
+						square_present[d] += gain * gain;
+						present[d]++;
+					}
+				}
+			}
+			evaluated += (long long)(next - n) * candidates;
+			n = next;
+
+			// find the leading node by its mean gain on the sample; a node
+			// outside a sampled cascade gains one node in it
+			leader = -1;
+			double leader_mean = -1.0;
+			for (int d = 0; d < num_nodes; d++) {
+				double mean = (double)(gain_present[d] + (n - present[d])) / n;
+				if (!chosen[d] && mean > leader_mean) {
+					leader_mean = mean;
+					leader = d;
+				}
+			}
+
+			// on the whole corpus the means are exact and the leader is the
+			// node main() would choose
+			if (n == num_cascades) {
+				break;
+			}
+
+			// stop once no other node's upper bound reaches the leader's lower bound
+			bool separated = true;
+			double leader_low = 0.0;
+			for (int pass = 0; pass < 2 && separated; pass++) {
+				for (int d = 0; d < num_nodes && separated; d++) {
+
+					if (chosen[d] || (pass == 0) != (d == leader)) {
+						continue;
+					}
+
+					long long sum = gain_present[d] + (n - present[d]);
+					long long square = square_present[d] + (n - present[d]);
+					double mean = (double)sum / n;
+					double variance = max(0.0, (double)square / n - mean * mean) * n / max(1, n - 1);
+					double radius = bernstein_radius(range, variance, n, delta);
+
+					if (pass == 0) {
+						leader_low = mean - radius;
+					}
+					else if (mean + radius >= leader_low) {
+						separated = false;
+					}
+
+				}
+			}
+
+			if (separated) {
+				break;
+			}
+
+		}
+
+		sample_sizes.push_back(n);
+		full += (long long)num_cascades * candidates;
+
+		// add the leading node to the approximately optimal set
+		chosen[leader] = 1;
+		S.insert(index.labels[leader]);
+		total += add_seed(index, covered, leader, scratch);
+
+	}
+
+	// print the sample size each iteration needed
+	cout << endl << "SAMPLE SIZE PER ITERATION (OF " << to_string(num_cascades) << " CASCADES):";
+	for (int n : sample_sizes) {
+		cout << " " << to_string(n);
+	}
+	cout << endl;
+
+	cout << endl << "CASCADE EVALUATIONS RELATIVE TO FULL CORPUS: "
+		<< to_string((double)evaluated / max(1LL, full)) << endl;
+
+	print_result(S, (double)total / num_cascades, start);
+
+}
+
+
+
+
+
+/*
+Function: racing_greedy
+Input: vector of maps, int, set of ints, bool
+Output: long long
+
+Description: Runs the greedy algorithm for k iterations with a
+successive-elimination race in each iteration, adds the selected nodes to S
+and returns the sum over all cascades of the nodes the set reaches. If report
+is set, prints how far the races went. The cascades are processed in random order in blocks of
+PARAM_RACE_BLOCK. After each block every remaining candidate gets an interval
+for its gain, and candidates whose upper bound falls below the leader's lower
+bound are dropped. With PARAM_RACE_EXACT set, the intervals are deterministic
+(the unprocessed cascades can add at most their uncovered nodes), so no
+candidate that could win is ever dropped. Otherwise they are empirical
+Bernstein intervals holding with probability PARAM_CONFIDENCE. The race ends
+when one candidate is left or all cascades are processed. The remaining
+contenders are then finished on all cascades, and the best of them is chosen
+with main()'s tie-break.
+*/
+long long racing_greedy(vector<map<int, vector<int> > >& cascades, int k, set<int>& S, bool report)
+{
+
+	CascadeIndex index;
+	build_cascade_index(cascades, index);
+
+	int num_cascades = cascades.size();
+	int num_nodes = index.labels.size();
+
+	TraversalScratch scratch;
+	prepare_scratch(index, scratch);
+
+	// the gain of a node in one cascade is at most the size of the largest cascade
+	double range = 1.0;
+	for (int c = 0; c < num_cascades; c++) {
+		range = max(range, (double)(index.cascade_begin[c + 1] - index.cascade_begin[c]));
+	}
+
+	int blocks = (num_cascades + PARAM_RACE_BLOCK - 1) / PARAM_RACE_BLOCK;
+
+	FlatFlags covered(index.slot_node.size(), 0);
+	vector<char> chosen(num_nodes, 0);
+	long long total = 0;
+
+	// cascade -> number of its slots not yet covered
+	vector<int> uncovered(num_cascades);
+	for (int c = 0; c < num_cascades; c++) {
+		uncovered[c] = index.cascade_begin[c + 1] - index.cascade_begin[c];
+	}
+
+	// random order of the cascades and the position of each cascade in it
+	vector<int> order(num_cascades);
+	vector<int> position(num_cascades);
+
+	// per node: gain summed over the processed cascades it appears in, the
+	// sum of squares of those gains, and the number of those cascades
+	vector<long long> gain_present(num_nodes);
+	vector<long long> square_present(num_nodes);
+	vector<int> present(num_nodes);
+
+	// per node: the number of unprocessed cascades it appears in, and their
+	// uncovered slots in total (a bound on what those cascades can add)
+	vector<int> remaining_present(num_nodes);
+	vector<long long> remaining_bound(num_nodes);
+
+	vector<char> alive(num_nodes);
+	vector<int> contenders;
+	vector<double> low(num_nodes);
+	vector<double> high(num_nodes);
+
+	long long evaluated = 0;
+	long long full = 0;
+	vector<int> processed_per_iteration;
+	vector<int> finishers_per_iteration;
+
+	// for K iterations corresponding to the K nodes to be selected, do
+	for (int iter = 0; iter < k && (int)S.size() < num_nodes; iter++) {
+
+		random_order(num_cascades, iter, order);
+		for (int i = 0; i < num_cascades; i++) {
+			position[order[i]] = i;
+		}
+
+		contenders.clear();
+		for (int d = 0; d < num_nodes; d++) {
+
+			alive[d] = !chosen[d];
+			gain_present[d] = 0;
+			square_present[d] = 0;
+			present[d] = 0;
+			remaining_present[d] = index.occurrence_begin[d + 1] - index.occurrence_begin[d];
+			remaining_bound[d] = 0;
+
+			if (alive[d]) {
+				contenders.push_back(d);
+				for (int o = index.occurrence_begin[d]; o < index.occurrence_begin[d + 1]; o++) {
+					remaining_bound[d] += uncovered[index.slot_cascade[index.occurrence_slot[o]]];
+				}
+			}
+
+		}
+
+		full += (long long)num_cascades * contenders.size();
+		double delta = (1.0 - PARAM_CONFIDENCE) / ((double)contenders.size() * blocks * k);
+
+		// race the contenders block by block
+		int n = 0;
+		while (n < num_cascades && contenders.size() > 1) {
+
+			int next = min(num_cascades, n + PARAM_RACE_BLOCK);
+
+			for (int i = n; i < next; i++) {
+
+				int c = order[i];
+
+				for (int slot = index.cascade_begin[c]; slot < index.cascade_begin[c + 1]; slot++) {
+
+					int d = index.slot_node[slot];
+
+					if (!alive[d]) {
+						continue;
+					}
+
+					long long gain = count_uncovered_reach(index, covered, slot, scratch);
+					gain_present[d] += gain;
+					square_present[d] += gain * gain;
+					present[d]++;
+					remaining_present[d]--;
+					remaining_bound[d] -= uncovered[c];
+
+				}
+
+			}
+
+			evaluated += (long long)(next - n) * contenders.size();
+			n = next;
+
+			if (n == num_cascades) {
+				break;
+			}
+
+			// compute each contender's interval and find the leader, the
+			// contender with the highest lower bound
+			int leader = -1;
+			for (int d : contenders) {
+
+				// a node outside a processed cascade gains one node in it
+				long long known = gain_present[d] + (n - present[d]);
+
+				if (PARAM_RACE_EXACT) {
+					// bounds on the total gain over all cascades
+					low[d] = known + ((num_cascades - n) - remaining_present[d]);
+					high[d] = low[d] + remaining_bound[d];
+				}
+				else {
+					// bounds on the mean gain per cascade
+					long long square = square_present[d] + (n - present[d]);
+					double mean = (double)known / n;
+					double variance = max(0.0, (double)square / n - mean * mean) * n / max(1, n - 1);
+					double radius = bernstein_radius(range, variance, n, delta);
+					low[d] = mean - radius;
+					high[d] = mean + radius;
+				}
+
+				if (leader == -1 || low[d] > low[leader]) {
+					leader = d;
+				}
+
+			}
+
+			// drop the contenders that cannot beat the leader; on a tie of
+			// exact bounds the smaller node wins, as in main()
+			int kept = 0;
+			for (int d : contenders) {
+
+				bool beaten = high[d] < low[leader] || (PARAM_RACE_EXACT && high[d] == low[leader] && d > leader);
+
+				if (d == leader || !beaten) {
+					contenders[kept++] = d;
+				}
+				else {
+					alive[d] = 0;
+				}
+
+			}
+			contenders.resize(kept);
+
+		}
+
+		processed_per_iteration.push_back(n);
+		finishers_per_iteration.push_back(contenders.size());
+
+		// finish the remaining contenders on the unprocessed cascades and
+		// choose the one with the largest exact gain
+		int winner = contenders[0];
+		long long winner_gain = -1;
+		if (contenders.size() > 1) {
+			for (int d : contenders) {
+
+				long long gain = gain_present[d] + (n - present[d]) + ((num_cascades - n) - remaining_present[d]);
+
+				for (int o = index.occurrence_begin[d]; o < index.occurrence_begin[d + 1]; o++) {
+					int slot = index.occurrence_slot[o];
+					if (position[index.slot_cascade[slot]] >= n) {
+						gain += count_uncovered_reach(index, covered, slot, scratch);
+					}
+				}
+
+				evaluated += num_cascades - n;
+
+				if (gain > winner_gain) {
+					winner_gain = gain;
+					winner = d;
+				}
+
+			}
+		}
+
+		// add the winner to the approximately optimal set
+		chosen[winner] = 1;
+		S.insert(index.labels[winner]);
+
+		for (int o = index.occurrence_begin[winner]; o < index.occurrence_begin[winner + 1]; o++) {
+			int slot = index.occurrence_slot[o];
+			int gain = cover_reach(index, covered, slot, scratch);
+			uncovered[index.slot_cascade[slot]] -= gain;
+			total += gain;
+		}
+		total += num_cascades - (index.occurrence_begin[winner + 1] - index.occurrence_begin[winner]);
+
+	}
+
+	// print how far each race had to go
+	if (report) {
+
+		cout << endl << "CASCADES PROCESSED BEFORE RACE ENDED (OF " << to_string(num_cascades) << "):";
+		for (int n : processed_per_iteration) {
+			cout << " " << to_string(n);
+		}
+		cout << endl;
+
+		cout << endl << "CONTENDERS FINISHED ON ALL CASCADES:";
+		for (int f : finishers_per_iteration) {
+			cout << " " << to_string(f);
+		}
+		cout << endl;
+
+		cout << endl << "CASCADE EVALUATIONS RELATIVE TO FULL CORPUS: " << to_string((double)evaluated / max(1LL, full)) << endl;
+
+	}
+
+	return total;
+
+}
+
+
+
+
+/*
+Function: run_racing_greedy
+Input: vector of maps
+Output: none
+
+Description: Runs racing_greedy for PARAM_K iterations and prints its result.
+*/
+void run_racing_greedy(vector<map<int, vector<int> > >& cascades)
+{
+
+	cout << endl << "RUNNING GREEDY ALGORITHM WITH CANDIDATE RACING..." << endl;
+
+	auto start = chrono::high_resolution_clock::now();
+
+	set<int> S;
+	long long total = racing_greedy(cascades, PARAM_K, S, true);
+
+	print_result(S, (double)total / cascades.size(), start);
+
+}
+
+
+
+
+
+/*
+Function: build_reach_sketches
+Input: cascade index, vector of vectors of pairs of doubles and ints
+Output: none
+
+Description: Builds a bottom-k reachability sketch (Cohen, 1997) for every
+node. Every slot gets a random rank, and the sketch of a node holds the
+PARAM_SKETCH_K smallest (rank, slot) pairs among the slots the node reaches in
+the cascades it appears in. In a cascade that is a DAG, the sketches of all
+slots are merged in reverse topological order. A cascade with a cycle falls
+back to one search per slot.
+*/
+void build_reach_sketches(CascadeIndex& index, vector<vector<pair<double, int> > >& sketches)
+{
+
+	int num_cascades = index.cascade_begin.size() - 1;
+
+	// the ranks of the slots of cascade c come from the stream of cascade c
+	vector<double> rank(index.slot_node.size());
+	for (int c = 0; c < num_cascades; c++) {
+		CounterRng rng(PARAM_RANDOM_SEED, c, 0);
+		for (int slot = index.cascade_begin[c]; slot < index.cascade_begin[c + 1]; slot++) {
+			rank[slot] = rng.unit();
+		}
+	}
+
+	sketches.assign(index.labels.size(), vector<pair<double, int> >());
+
+	TraversalScratch scratch;
+	prepare_scratch(index, scratch);
+
+	vector<int> in_degree(index.slot_node.size(), 0);
+	vector<int> topological;
+	vector<vector<pair<double, int> > > slot_sketch;
+	vector<int> reach;
+
+	// for each cascade, do
+	for (int c = 0; c < num_cascades; c++) {
+
+		int first = index.cascade_begin[c];
+		int last = index.cascade_begin[c + 1];
+
+		// order the slots of the cascade topologically (Kahn's algorithm)
+		for (int u = first; u < last; u++) {
+			for (int e = index.edge_begin[u]; e < index.edge_begin[u + 1]; e++) {
+				in_degree[index.edge_target[e]]++;
+			}
+		}
+
+		topological.clear();
+		for (int u = first; u < last; u++) {
+			if (in_degree[u] == 0) {
+				topological.push_back(u);
+			}
+		}
+		for (int head = 0; head < (int)topological.size(); head++) {
+			int u = topological[head];
+			for (int e = index.edge_begin[u]; e < index.edge_begin[u + 1]; e++) {
+				if (--in_degree[index.edge_target[e]] == 0) {
+					topological.push_back(index.edge_target[e]);
+				}
+			}
+		}
+
+		slot_sketch.assign(last - first, vector<pair<double, int> >());
+
+		if ((int)topological.size() == last - first) {
+
+			// each slot's sketch is the bottom-k of its own rank and its
+			// children's sketches
+			for (int i = topological.size() - 1; i >= 0; i--) {
+
+				int u = topological[i];
+				vector<pair<double, int> >& sketch = slot_sketch[u - first];
+
+				sketch.push_back(make_pair(rank[u], u));
+				for (int e = index.edge_begin[u]; e < index.edge_begin[u + 1]; e++) {
+					vector<pair<double, int> >& child = slot_sketch[index.edge_target[e] - first];
+					sketch.insert(sketch.end(), child.begin(), child.end());
+				}
+
+				sort(sketch.begin(), sketch.end());
+				sketch.erase(unique(sketch.begin(), sketch.end()), sketch.end());
+				if (sketch.size() > PARAM_SKETCH_K) {
+					sketch.resize(PARAM_SKETCH_K);
+				}
+
+			}
+
+		}
+		else {
+
+			// the cascade has a cycle; search from every slot instead
+			for (int u = first; u < last; u++) {
+
+				in_degree[u] = 0;
+
+				collect_reach(index, u, scratch, reach);
+
+				vector<pair<double, int> >& sketch = slot_sketch[u - first];
+				for (int v : reach) {
+					sketch.push_back(make_pair(rank[v], v));
+				}
+
+				sort(sketch.begin(), sketch.end());
+				if (sketch.size() > PARAM_SKETCH_K) {
+					sketch.resize(PARAM_SKETCH_K);
+				}
+
+			}
+
+		}
+
+		// merge the slot sketches into the sketches of their nodes
+		for (int u = first; u < last; u++) {
+
+			vector<pair<double, int> >& sketch = sketches[index.slot_node[u]];
+			sketch.insert(sketch.end(), slot_sketch[u - first].begin(), slot_sketch[u - first].end());
+
+			if (sketch.size() > 2 * PARAM_SKETCH_K) {
+				sort(sketch.begin(), sketch.end());
+				sketch.resize(PARAM_SKETCH_K);
+			}
+
+		}
+
+	}
+
+	for (vector<pair<double, int> >& sketch : sketches) {
+		sort(sketch.begin(), sketch.end());
+		if (sketch.size() > PARAM_SKETCH_K) {
+			sketch.resize(PARAM_SKETCH_K);
+		}
+	}
+
+}
+
+
+
+
+/*
+Function: screening_greedy
+Input: vector of maps, int, set of ints, bool
+Output: long long
+
+Description: Runs the greedy algorithm for k iterations in two stages per
+iteration, adds the selected nodes to S and returns the sum over all cascades
+of the nodes the set reaches. First, the reachability sketches estimate every
+candidate's marginal gain, with an error of about PARAM_SCREEN_Z standard
+errors (none for nodes whose sketch holds their whole reach). The shortlist
+is every candidate whose estimate could reach the highest lower estimate,
+and it is evaluated exactly. The sketches only pick and size the shortlist:
+the best exact gain is certified against bounds that always hold, namely the
+candidate's last exact gain (valid because influence is submodular) and the
+sum over its uncovered slots of their reach bounds (see CascadeStats), each
+capped by the uncovered slots of its cascade. While some candidate outside
+the shortlist could still beat or tie the best exact gain by these bounds,
+it is evaluated too, so the result is the same as main()'s. If report is
+set, prints the shortlist sizes and how often a shortlist had to be expanded.
+*/
+long long screening_greedy(vector<map<int, vector<int> > >& cascades, int k, set<int>& S, bool report)
+{
+
+	CascadeIndex index;
+	build_cascade_index(cascades, index);
+
+	CascadeStats stats;
+	build_cascade_stats(cascades, stats);
+
+	vector<vector<pair<double, int> > > sketches;
+	build_reach_sketches(index, sketches);
+
+	int num_cascades = cascades.size();
+	int num_nodes = index.labels.size();
+
+	TraversalScratch scratch;
+	prepare_scratch(index, scratch);
+
+	FlatFlags covered(index.slot_node.size(), 0);
+	vector<char> chosen(num_nodes, 0);
+	long long total = 0;
+
+	// cascade -> number of its slots not covered yet
+	vector<int> uncovered(num_cascades);
+	for (int c = 0; c < num_cascades; c++) {
+		uncovered[c] = index.cascade_begin[c + 1] - index.cascade_begin[c];
+	}
+
+	// node -> last exact marginal gain (an upper bound on later gains)
+	const double unbounded = 1e300;
+	vector<double> last_exact(num_nodes, unbounded);
+
+	// node -> sketch estimates of its gain, and a bound that always holds
+	vector<double> low(num_nodes);
+	vector<double> high(num_nodes);
+	vector<double> sure(num_nodes);
+	vector<char> evaluated(num_nodes);
+	vector<long long> exact(num_nodes);
+
+	long long exact_evaluations = 0;
+	long long candidate_count = 0;
+	int expansions = 0;
+	vector<int> shortlist_sizes;
+
+	// for k iterations corresponding to the k nodes to be selected, do
+	for (int iter = 0; iter < k && (int)S.size() < num_nodes; iter++) {
+
+		// stage one: bound every candidate's gain with its sketch
+		double best_low = -1.0;
+		for (int d = 0; d < num_nodes; d++) {
+
+			if (chosen[d]) {
+				continue;
+			}
+
+			candidate_count++;
+
+			vector<pair<double, int> >& sketch = sketches[d];
+
+			int uncovered_entries = 0;
+			for (auto& entry : sketch) {
+				uncovered_entries += !covered[entry.second];
+			}
+
+			// a node reaches itself in every cascade it does not appear in
+			double absent = num_cascades - (index.occurrence_begin[d + 1] - index.occurrence_begin[d]);
+
+			if (sketch.size() < PARAM_SKETCH_K) {
+
+				// the sketch holds the node's whole reach, so the gain is exact
+				low[d] = absent + uncovered_entries;
+				high[d] = low[d];
+
+			}
+			else {
+
+				double reach = (PARAM_SKETCH_K - 1) / sketch.back().first;
+				double estimate = reach * uncovered_entries / PARAM_SKETCH_K;
+				double radius = PARAM_SCREEN_Z * reach / sqrt(PARAM_SKETCH_K - 2.0);
+
+				low[d] = absent + max(0.0, estimate - radius);
+				high[d] = absent + estimate + radius;
+
+			}
+
+			// every uncovered slot adds at most its reach, and at most the
+			// uncovered slots of its cascade
+			long long bound = absent;
+			for (int o = index.occurrence_begin[d]; o < index.occurrence_begin[d + 1]; o++) {
+				int slot = index.occurrence_slot[o];
+				if (!covered[slot]) {
+					bound += min(stats.reach_bound[slot], uncovered[index.slot_cascade[slot]]);
+				}
+			}
+			sure[d] = min((double)bound, last_exact[d]);
+
+			high[d] = min(high[d], sure[d]);
+			low[d] = min(low[d], high[d]);
+			best_low = max(best_low, low[d]);
+			evaluated[d] = 0;
+
+		}
+
+		// stage two: evaluate the shortlist exactly; an expansion takes the
+		// candidates whose sure bound reaches the best exact gain
+		int winner = -1;
+		int shortlist = 0;
+		double threshold = best_low;
+		bool expanded = false;
+
+		while (true) {
+
+			for (int d = 0; d < num_nodes; d++) {
+
+				if (chosen[d] || evaluated[d] || (expanded ? sure[d] : high[d]) < threshold) {
+					continue;
+				}
+
+				exact[d] = marginal_gain(index, covered, d, scratch);
+				last_exact[d] = exact[d];
+				evaluated[d] = 1;
+				shortlist++;
+				exact_evaluations++;
+
+				if (winner == -1 || exact[d] > exact[winner] || (exact[d] == exact[winner] && d < winner)) {
+					winner = d;
+				}
+
+			}
+
+			// the winner is certified if no unevaluated candidate could beat
+			// it (ties go to the smaller node, as in main())
+			bool certified = true;
+			for (int d = 0; d < num_nodes && certified; d++) {
+				if (!chosen[d] && !evaluated[d] && (sure[d] > exact[winner] || (sure[d] == exact[winner] && d < winner))) {
+					certified = false;
+				}
+			}
+
+			if (certified) {
+				break;
+			}
+
+			// expand the shortlist with every candidate that could still win
+			expanded = true;
+			threshold = exact[winner];
+
+		}
+
+		expansions += expanded;
+		shortlist_sizes.push_back(shortlist);
+
+		// add the winner to the approximately optimal set
+		chosen[winner] = 1;
+		S.insert(index.labels[winner]);
+
+		for (int o = index.occurrence_begin[winner]; o < index.occurrence_begin[winner + 1]; o++) {
+			int slot = index.occurrence_slot[o];
+			int gain = cover_reach(index, covered, slot, scratch);
+			uncovered[index.slot_cascade[slot]] -= gain;
+			total += gain;
+		}
+		total += num_cascades - (index.occurrence_begin[winner + 1] - index.occurrence_begin[winner]);
+
+	}
+
+	// print the size of the shortlist of each iteration and the expansions
+	if (report) {
+
+		cout << endl << "SHORTLIST SIZE PER ITERATION:";
+		for (int size : shortlist_sizes) {
+			cout << " " << to_string(size);
+		}
+		cout << endl;
+
+		cout << endl << "ITERATIONS WHOSE SHORTLIST HAD TO BE EXPANDED: " << to_string(expansions) << " OF " << to_string(shortlist_sizes.size()) << endl;
+
+		cout << endl << "EXACT EVALUATIONS RELATIVE TO FULL SCAN: " << to_string((double)exact_evaluations / max(1LL, candidate_count)) << endl;
+
+	}
+
+	return total;
+
+}
+
+
+
+
+/*
+Function: run_screening_greedy
+Input: vector of maps
+Output: none
+
+Description: Runs screening_greedy for PARAM_K iterations and prints its
+result.
+*/
+void run_screening_greedy(vector<map<int, vector<int> > >& cascades)
+{
+
+	cout << endl << "RUNNING GREEDY ALGORITHM WITH SKETCH SCREENING..." << endl;
+
+	auto start = chrono::high_resolution_clock::now();
+
+	set<int> S;
+	long long total = screening_greedy(cascades, PARAM_K, S, true);
+
+	print_result(S, (double)total / cascades.size(), start);
+
+}
+
+
+
+
+
+/*
+Structure: ReachBitsets
+Description: The reach of every slot of a cascade index as a bitset over the
+			 slots of its cascade, for the cascades of at most
+			 PARAM_BITSET_MAX_SLOTS slots. Bit i of a cascade's bitsets stands
+			 for its i-th slot. A cascade with n slots takes n * ceil(n / 64)
+			 words.
+*/
+struct ReachBitsets
+{
+
+	// cascade -> first word of its coverage bitset, or -1 if the cascade has
+	// no bitsets
+	vector<long long> cascade_word;
+
+	// slot -> first word of its reach bitset (in cascades with bitsets)
+	vector<long long> slot_word;
+
+	// the reach bitsets, and the number of coverage words
+	vector<uint64_t> reach;
+	long long cover_words = 0;
+
+	int words(CascadeIndex& index, int c)
+	{
+		return (index.cascade_begin[c + 1] - index.cascade_begin[c] + 63) / 64;
+	}
+
+};
+
+
+
+
+/*
+Function: build_reach_bitsets
+Input: cascade index, reach bitsets
+Output: none
+
+Description: Fills the reach bitsets of every cascade of at most
+PARAM_BITSET_MAX_SLOTS slots with one breadth-first search per slot.
+*/
+void build_reach_bitsets(CascadeIndex& index, ReachBitsets& bits)
+{
+
+	int num_cascades = index.num_cascades();
+
+	TraversalScratch scratch;
+	prepare_scratch(index, scratch);
+
+	bits.cascade_word.assign(num_cascades, -1);
+	bits.slot_word.assign(index.num_ids(), -1);
+	bits.reach.clear();
+	bits.cover_words = 0;
+
+	vector<int> reach;
+
+	for (int c = 0; c < num_cascades; c++) {
+
+		int first = index.cascade_begin[c];
+		int size = index.cascade_begin[c + 1] - first;
+
+		if (size > PARAM_BITSET_MAX_SLOTS) {
+			continue;
+		}
+
+		int words = bits.words(index, c);
+		bits.cascade_word[c] = bits.cover_words;
+		bits.cover_words += words;
+
+		for (int slot = first; slot < first + size; slot++) {
+
+			bits.slot_word[slot] = bits.reach.size();
+			bits.reach.resize(bits.reach.size() + words, 0);
+			uint64_t* row = &bits.reach[bits.slot_word[slot]];
+
+			collect_reach(index, slot, scratch, reach);
+			for (int v : reach) {
+				row[(v - first) / 64] |= (uint64_t)1 << ((v - first) % 64);
+			}
+
+		}
+
+	}
+
+}
+
+
+
+
+/*
+Function: bitset_greedy
+Input: vector of maps, int, set of ints
+Output: long long
+
+Description: Runs the greedy algorithm for k iterations with reach bitsets
+(see ReachBitsets), adds the selected nodes to S and returns the sum over all
+cascades of the nodes the set reaches. In a cascade with bitsets, the gain of
+a slot is the number of bits of its reach that are not in the cascade's
+coverage bitset, counted a word at a time, and selecting it ORs its reach
+into the coverage. Larger cascades are searched as in the other engines.
+Ties go to the smaller node, as in main().
+*/
+long long bitset_greedy(vector<map<int, vector<int> > >& cascades, int k, set<int>& S)
+{
+
+	CascadeIndex index;
+	build_cascade_index(cascades, index);
+
+	ReachBitsets bits;
+	build_reach_bitsets(index, bits);
+
+	int num_cascades = index.num_cascades();
+	int num_nodes = index.num_nodes();
+
+	TraversalScratch scratch;
+	prepare_scratch(index, scratch);
+
+	// coverage of the cascades with bitsets, and of the searched cascades
+	vector<uint64_t> covered_bits(bits.cover_words, 0);
+	FlatFlags covered(index.num_ids(), 0);
+	vector<char> chosen(num_nodes, 0);
+	long long total = 0;
+
+	for (int iter = 0; iter < k && (int)S.size() < num_nodes; iter++) {
+
+		int best = -1;
+		long long best_gain = -1;
+
+		for (int d = 0; d < num_nodes; d++) {
+
+			if (chosen[d]) {
+				continue;
+			}
+
+			IdRange occurrences = index.occurrences(d);
+
+			// a node reaches itself in every cascade it does not appear in
+			long long gain = num_cascades - (occurrences.end() - occurrences.begin());
+
+			for (int slot : occurrences) {
+
+				int c = index.cascade(slot);
+
+				if (bits.cascade_word[c] == -1) {
+					gain += count_uncovered_reach(index, covered, slot, scratch);
+					continue;
+				}
+
+				const uint64_t* row = &bits.reach[bits.slot_word[slot]];
+				const uint64_t* cover = &covered_bits[bits.cascade_word[c]];
+				for (int w = bits.words(index, c) - 1; w >= 0; w--) {
+					gain += __builtin_popcountll(row[w] & ~cover[w]);
+				}
+
+			}
+
+			if (gain > best_gain) {
+				best_gain = gain;
+				best = d;
+			}
+
+		}
+
+		// add the best node to the approximately optimal set
+		chosen[best] = 1;
+		S.insert(index.labels[best]);
+		total += best_gain;
+
+		for (int slot : index.occurrences(best)) {
+
+			int c = index.cascade(slot);
+
+			if (bits.cascade_word[c] == -1) {
+				cover_reach(index, covered, slot, scratch);
+				continue;
+			}
+
+			const uint64_t* row = &bits.reach[bits.slot_word[slot]];
+			uint64_t* cover = &covered_bits[bits.cascade_word[c]];
+			for (int w = bits.words(index, c) - 1; w >= 0; w--) {
+				cover[w] |= row[w];
+			}
+
+		}
+
+	}
+
+	return total;
+
+}
+
+
+
+
+/*
+Function: run_bitset_greedy
+Input: vector of maps
+Output: none
+
+Description: Runs bitset_greedy for PARAM_K iterations and prints its result.
+*/
+void run_bitset_greedy(vector<map<int, vector<int> > >& cascades)
+{
+
+	cout << endl << "RUNNING GREEDY ALGORITHM WITH REACH BITSETS..." << endl;
+
+	auto start = chrono::high_resolution_clock::now();
+
+	set<int> S;
+	long long total = bitset_greedy(cascades, PARAM_K, S);
+
+	print_result(S, (double)total / cascades.size(), start);
+
+}
+
+
+
+
+/*
+Function: weighted_greedy
+Input: storage, vector of doubles, int, vector of ints
+Output: none
+
+Description: Runs the greedy algorithm on cascades that carry weights, where
+the influence of a set is the weighted average of its reach. Appends the
+dense ids of the selected nodes to order, in selection order. Runs on a
+cascade index or on any storage backend with occurrences (see CsrStore).
+*/
+template <class Store>
+void weighted_greedy(Store& index, vector<double>& weights, int k, vector<int>& order)
+{
+
+	int num_nodes = index.num_nodes();
+
+	TraversalScratch scratch;
+	prepare_scratch(index, scratch);
+
+	FlatFlags covered(index.num_ids(), 0);
+	vector<char> chosen(num_nodes, 0);
+
+	double total_weight = 0.0;
+	for (double w : weights) {
+		total_weight += w;
+	}
+
+	for (int iter = 0; iter < k && (int)order.size() < num_nodes; iter++) {
+
+		int best = -1;
+		double best_gain = -1.0;
+
+		for (int d = 0; d < num_nodes; d++) {
+
+			if (chosen[d]) {
+				continue;
+			}
+
+			// a node reaches itself in every cascade it does not appear in
+			double gain = total_weight;
+
+			for (int slot : index.occurrences(d)) {
+				double w = weights[index.cascade(slot)];
+				gain += w * (count_uncovered_reach(index, covered, slot, scratch) - 1);
+			}
+
+			if (gain > best_gain) {
+				best_gain = gain;
+				best = d;
+			}
+
+		}
+
+		chosen[best] = 1;
+		order.push_back(best);
+		add_seed(index, covered, best, scratch);
+
+	}
+
+}
+
+
+
+
+/*
+Function: weighted_influence
+Input: storage, vector of doubles, vector of ints
+Output: double
+
+Description: Returns the weighted average over the cascades of the number of
+nodes reachable from the given nodes (dense ids).
+*/
+template <class Store>
+double weighted_influence(Store& index, vector<double>& weights, vector<int>& seeds)
+{
+
+	TraversalScratch scratch;
+	prepare_scratch(index, scratch);
+
+	FlatFlags covered(index.num_ids(), 0);
+
+	double reach = 0.0;
+	double total_weight = 0.0;
+
+	for (int c = 0; c < (int)weights.size(); c++) {
+		total_weight += weights[c];
+		reach += weights[c] * seeds.size();
+	}
+
+	// a seed outside a cascade still reaches itself there; a seed inside adds
+	// what it newly covers
+	for (int d : seeds) {
+		for (int slot : index.occurrences(d)) {
+			double w = weights[index.cascade(slot)];
+			reach += w * (cover_reach(index, covered, slot, scratch) - 1);
+		}
+	}
+
+	return reach / total_weight;
+
+}
+
+
+
+
+/*
+Function: run_weighted_greedy
+Input: vector of maps, vector of doubles
+Output: none
+
+Description: Runs weighted_greedy for PARAM_K iterations on cascades that
+carry weights, such as a coreset read back from CORESET_DIRECTORY, and prints
+the selected set and its weighted influence.
+*/
+void run_weighted_greedy(vector<map<int, vector<int> > >& cascades, vector<double>& weights)
+{
+
+	cout << endl << "RUNNING WEIGHTED GREEDY ALGORITHM..." << endl;
+
+	auto start = chrono::high_resolution_clock::now();
+
+	CascadeIndex index;
+	build_cascade_index(cascades, index);
+
+	vector<int> order;
+	weighted_greedy(index, weights, PARAM_K, order);
+
+	set<int> S;
+	for (int d : order) {
+		S.insert(index.labels[d]);
+	}
+
+	print_result(S, weighted_influence(index, weights, order), start);
+
+}
+
+
+
+
+/*
+Function: run_coreset
+Input: vector of maps, vector of strings
+Output: none
+
+Description: Builds a weighted coreset of the cascades and writes it to
+CORESET_DIRECTORY. Cascades are drawn with replacement with probability
+proportional to their size plus PARAM_K, an upper bound on what any set of at
+most PARAM_K seeds can reach in them (sensitivity sampling). Each distinct
+cascade drawn is written once, with the weight count / (draws * probability)
+in a "# weight" comment line. The loader reads the weights back (see
+parse_cascade_weight), so main() runs the weighted greedy algorithm on the
+coreset directory; other readers skip the line as a comment. The number of draws is PARAM_CORESET_SIZE. If
+that is zero, it comes from Hoeffding's inequality and a union bound over all
+seed sets of size PARAM_K, so that their weighted influence is within a
+relative PARAM_CORESET_EPSILON of the full influence with probability
+PARAM_CONFIDENCE. Runs the weighted greedy algorithm on the coreset and reports
+the error of every prefix of the chosen seed sequence against the full cascades.
+*/
+void run_coreset(vector<map<int, vector<int> > >& cascades, vector<string>& cascade_names)
+{
+
+	CascadeIndex index;
+	build_cascade_index(cascades, index);
+
+	cout << endl << "BUILDING CORESET..." << endl;
+
+	auto start = chrono::high_resolution_clock::now();
+
+	int num_cascades = cascades.size();
+	int num_nodes = index.labels.size();
+
+	// sampling mass of each cascade and in total
+	vector<double> mass(num_cascades);
+	double total_mass = 0.0;
+	for (int c = 0; c < num_cascades; c++) {
+		mass[c] = index.cascade_begin[c + 1] - index.cascade_begin[c] + PARAM_K;
+		total_mass += mass[c];
+	}
+
+	// a draw of cascade c estimates the average reach by reach / (p_c * N),
+	// which lies in [0, total_mass / N]; influence of a PARAM_K-set is at least PARAM_K
+	long long draws = PARAM_CORESET_SIZE;
+	if (draws <= 0) {
+		double range = total_mass / num_cascades;
+		double log_sets = PARAM_K * log(max(2, num_nodes)) + log(2.0 / (1.0 - PARAM_CONFIDENCE));
+		double error = PARAM_CORESET_EPSILON * PARAM_K;
+		draws = ceil(range * range * log_sets / (2.0 * error * error));
+	}
+
+	// draw cascades by inverting the running sum of the masses
+	vector<double> cumulative(num_cascades);
+	partial_sum(mass.begin(), mass.end(), cumulative.begin());
+
+	CounterRng rng(PARAM_RANDOM_SEED, 0, 0);
+	map<int, long long> counts;
+	for (long long i = 0; i < draws; i++) {
+		int c = upper_bound(cumulative.begin(), cumulative.end(), rng.unit() * total_mass) - cumulative.begin();
+		counts[min(c, num_cascades - 1)]++;
+	}
+
+	// write the coreset, replacing any coreset written before
+	filesystem::create_directories(CORESET_DIRECTORY);
+	for (auto file : filesystem::directory_iterator(CORESET_DIRECTORY)) {
+		string name = file.path().filename().string();
+		if (name.rfind("coreset_", 0) == 0 && name.find(".txt") != string::npos) {
+			filesystem::remove(file.path());
+		}
+	}
+
+	vector<map<int, vector<int> > > coreset;
+	vector<double> weights;
+
+	for (auto& entry : counts) {
+
+		int c = entry.first;
+		double weight = entry.second / (draws * mass[c] / total_mass);
+
+		string file_name = (filesystem::path(CORESET_DIRECTORY) / ("coreset_" + to_string(coreset.size()) + ".txt")).string();
+		ofstream outfile(file_name.c_str());
+
+		// all 17 significant digits, so the weight reads back exactly
+		outfile << "# weight " << setprecision(17) << weight << endl;
+		outfile << "# source " << filesystem::path(cascade_names[c]).filename().string() << endl;
+		for (auto& adjacency : cascades[c]) {
+			for (int to : adjacency.second) {
+				outfile << adjacency.first << " " << to << endl;
+			}
+		}
+
+		coreset.push_back(cascades[c]);
+		weights.push_back(weight);
+
+	}
+
+	cout << endl << "CORESET WRITTEN! NUMBER OF CASCADES: " << to_string(coreset.size()) << " OF " << to_string(num_cascades)
+		<< " (" << to_string(draws) << " DRAWS)" << endl;
+
+	// run the weighted greedy algorithm on the coreset
+	CascadeIndex core_index;
+	build_cascade_index(coreset, core_index);
+
+	vector<int> core_order;
+	weighted_greedy(core_index, weights, PARAM_K, core_order);
+
+	// compare the coreset's estimate of each prefix of the chosen sequence
+	// with its influence on the full cascades
+	vector<double> unit(num_cascades, 1.0);
+	vector<int> core_prefix;
+	vector<int> full_prefix;
+	set<int> S;
+	double max_error = 0.0;
+	double full_influence = 0.0;
+
+	cout << endl << "PREFIX SIZE, CORESET INFLUENCE, FULL INFLUENCE, RELATIVE ERROR" << endl;
+
+	for (int d : core_order) {
+
+		int label = core_index.labels[d];
+		S.insert(label);
+		core_prefix.push_back(d);
+		full_prefix.push_back(lower_bound(index.labels.begin(), index.labels.end(), label) - index.labels.begin());
+
+		double core_influence = weighted_influence(core_index, weights, core_prefix);
+		full_influence = weighted_influence(index, unit, full_prefix);
+		double error = fabs(core_influence - full_influence) / full_influence;
+		max_error = max(max_error, error);
+
+		cout << to_string(core_prefix.size()) << ", " << to_string(core_influence) << ", " << to_string(full_influence) << ", " << to_string(error) << endl;
+
+	}
+
+	cout << endl << "MAXIMUM RELATIVE ERROR OF CORESET INFLUENCE: " << to_string(max_error) << endl;
+
+	print_result(S, full_influence, start);
+
+}
+
+
+
+
+
+/*
+Structure: ReachCache
+Description: Cache of the reach lists of slots (see collect_reach), filled on
+			 demand. Each LazyShard owns one, used only by the shard's worker,
+			 so the cache takes no locks. Its memory use is capped (the
+			 shards split PARAM_CACHE_MB); when full, entries are evicted with
+			 the CLOCK approximation of least-recently-used. A list returned
+			 by get or put stays valid until the next call to put.
+*/
+struct ReachCache
+{
+
+	struct Entry
+	{
+		int slot;
+		vector<int> reach;
+		bool referenced;
+	};
+
+	unordered_map<int, int> position;
+	vector<Entry> ring;
+	int hand = 0;
+	size_t bytes = 0;
+	size_t capacity = 0;
+
+	// lookups that found their list, and lookups that did not
+	long long hits = 0;
+	long long misses = 0;
+
+	ReachCache(size_t capacity_bytes) : capacity(capacity_bytes) {}
+
+	// bytes accounted for one cached list
+	static size_t entry_bytes(const vector<int>& reach)
+	{
+		return reach.size() * sizeof(int) + sizeof(Entry) + 64;
+	}
+
+	const vector<int>* get(int slot)
+	{
+
+		auto found = position.find(slot);
+
+		if (found == position.end()) {
+			misses++;
+			return NULL;
+		}
+
+		hits++;
+		Entry& entry = ring[found->second];
+		entry.referenced = true;
+
+		return &entry.reach;
+
+	}
+
+	// takes over the contents of reach and returns the cached list, or
+	// returns NULL and leaves reach alone if the list is too large to cache
+	const vector<int>* put(int slot, vector<int>& reach)
+	{
+
+		size_t added = entry_bytes(reach);
+
+		if (added > capacity || position.count(slot)) {
+			return NULL;
+		}
+
+		// sweep the clock hand, giving referenced entries a second chance,
+		// until the new list fits
+		while (bytes + added > capacity) {
+
+			if (hand >= (int)ring.size()) {
+				hand = 0;
+			}
+
+			Entry& entry = ring[hand];
+
+			if (entry.referenced) {
+				entry.referenced = false;
+				hand++;
+				continue;
+			}
+
+			// evict the entry by moving the last entry into its place
+			bytes -= entry_bytes(entry.reach);
+			position.erase(entry.slot);
+
+			if (hand != (int)ring.size() - 1) {
+				entry = move(ring.back());
+				position[entry.slot] = hand;
+			}
+			ring.pop_back();
+
+		}
+
+		position[slot] = ring.size();
+		ring.push_back(Entry{slot, vector<int>(), false});
+		ring.back().reach.swap(reach);
+		bytes += added;
+
+		return &ring.back().reach;
+
+	}
+
+};
+
+
+
+
+/*
+Function: count_unmarked_reach
+Input: cascade index, vector of chars, vector of ints, int, int, traversal scratch
+Output: int
+
+Description: Same as count_uncovered_reach, but also treats the slots whose
+mark equals mark_id as covered.
+*/
+int count_unmarked_reach(CascadeIndex& index, FlatFlags& covered, FlatInts& mark, int mark_id, int slot, TraversalScratch& scratch)
+{
+
+	if (covered[slot] || mark[slot] == mark_id) {
+		return 0;
+	}
+
+	int stamp = ++scratch.current;
+
+	scratch.queue.clear();
+	scratch.queue.push_back(slot);
+	scratch.stamp[slot] = stamp;
+
+	for (int head = 0; head < (int)scratch.queue.size(); head++) {
+
+		prefetch_frontier(index, scratch.stamp.data(), covered.data(), scratch.queue, head);
+
+		int u = scratch.queue[head];
+
+		for (int e = index.edge_begin[u]; e < index.edge_begin[u + 1]; e++) {
+
+			int v = index.edge_target[e];
+
+			if (!covered[v] && mark[v] != mark_id && scratch.stamp[v] != stamp) {
+				scratch.stamp[v] = stamp;
+				scratch.queue.push_back(v);
+			}
+
+		}
+
+	}
+
+	return scratch.queue.size();
+
+}
+
+
+
+
+/*
+Function: lazy_gains
+Input: cascade index, vector of chars, vector of ints, int, int, traversal
+	   scratch, reach cache, two long longs
+Output: none
+
+Description: Computes the marginal gain of the node with dense id d against the
+current coverage. If mark_id is not zero, also computes its speculative gain
+for the next iteration: the gain against the current coverage plus the slots
+marked with mark_id, which are the slots the current leader would cover.
+Uses the reach cache if PARAM_CACHE_MB is positive, in which case both gains
+come from one pass over each list.
+*/
+void lazy_gains(CascadeIndex& index, FlatFlags& covered, FlatInts& mark, int mark_id, int d,
+	TraversalScratch& scratch, ReachCache& cache, long long& gain, long long& speculative)
+{
+
+	int num_cascades = index.cascade_begin.size() - 1;
+	int present = index.occurrence_begin[d + 1] - index.occurrence_begin[d];
+
+	// a node reaches itself in every cascade it does not appear in
+	gain = num_cascades - present;
+	speculative = gain;
+
+	for (int o = index.occurrence_begin[d]; o < index.occurrence_begin[d + 1]; o++) {
+
+		int slot = index.occurrence_slot[o];
+
+		if (covered[slot]) {
+			continue;
+		}
+
+		if (PARAM_CACHE_MB <= 0) {
+			gain += count_uncovered_reach(index, covered, slot, scratch);
+			if (mark_id != 0) {
+				speculative += count_unmarked_reach(index, covered, mark, mark_id, slot, scratch);
+			}
+			continue;
+		}
+
+		const vector<int>* reach = cache.get(slot);
+
+		// a list too large to cache is used from the scratch queue
+		if (reach == NULL) {
+			collect_reach(index, slot, scratch, scratch.queue);
+			reach = cache.put(slot, scratch.queue);
+			if (reach == NULL) {
+				reach = &scratch.queue;
+			}
+		}
+
+		for (int v : *reach) {
+			gain += !covered[v];
+			speculative += !covered[v] && mark[v] != mark_id;
+		}
+
+	}
+
+}
+
+
+
+
+/*
+Structure: LazyShard
+Description: One worker's share of the cascades for the lazy greedy: the
+			 cascades first to last - 1, with their own cascade index,
+			 coverage, scratch space, reach cache and speculation marks. Only
+			 worker w reads and writes shard w while gains are evaluated; the
+			 coverage update after a selection splits the shard by cascade
+			 instead. local maps the global dense node ids to the shard's
+			 dense ids (-1 for nodes that do not appear in the shard), and
+			 global maps them back. reverse_begin and reverse_source hold
+			 the incoming edges of each slot (laid out like edge_begin and
+			 edge_target), and invalid_stamp marks the slots whose gains the
+			 last selection invalidated.
+*/
+struct LazyShard
+{
+	int first = 0;
+	int last = 0;
+	CascadeIndex index;
+	vector<int> local;
+	vector<int> global;
+	FlatFlags covered;
+	TraversalScratch scratch;
+	unique_ptr<ReachCache> cache;
+	FlatInts mark;
+	FlatInts reverse_begin;
+	FlatInts reverse_source;
+	FlatInts invalid_stamp;
+};
+
+
+
+
+/*
+Structure: LazyStats
+Description: Timings and counters of one run of lazy_greedy.
+*/
+struct LazyStats
+{
+	int num_nodes = 0;
+	long long num_slots = 0;
+	size_t shard_bytes = 0;
+	double build_seconds = 0;
+	double greedy_seconds = 0;
+	long long evaluations = 0;
+	long long speculation_used = 0;
+	long long speculation_discarded = 0;
+	long long invalidated = 0;
+	long long gains_kept = 0;
+	vector<double> hit_rates;
+	vector<IterationRanking> rankings;
+	vector<long long> iteration_allocations;
+};
+
+
+
+
+/*
+Function: set_interleaved_placement
+Input: bool
+Output: none
+
+Description: If interleave is set, spreads the memory the calling thread
+allocates from now on page by page over all NUMA nodes; otherwise restores
+the default policy, which places each page on the node of the thread that
+first touches it. Does nothing on systems without NUMA support.
+*/
+void set_interleaved_placement(bool interleave)
+{
+
+	// policies of set_mempolicy(2)
+	const int POLICY_DEFAULT = 0;
+	const int POLICY_INTERLEAVE = 3;
+
+	if (!interleave) {
+		syscall(SYS_set_mempolicy, POLICY_DEFAULT, NULL, 0);
+		return;
+	}
+
+	unsigned long nodes = 0;
+	for (int node : thread_pool().node_ids) {
+		if (node < 64) {
+			nodes |= 1UL << node;
+		}
+	}
+
+	syscall(SYS_set_mempolicy, POLICY_INTERLEAVE, &nodes, 65);
+
+}
+
+
+
+
+/*
+Function: build_lazy_shard
+Input: vector of maps, vector of ints, int, lazy shard
+Output: none
+
+Description: Builds the data of a lazy shard whose cascade range is set,
+given the labels of all nodes in ascending order and the number of shards
+(which share the reach cache memory). The thread that calls it touches all
+of the shard's memory first.
+*/
+void build_lazy_shard(vector<map<int, vector<int> > >& cascades, vector<int>& labels, int num_shards, LazyShard& shard)
+{
+
+	build_cascade_index(cascades, shard.index, shard.first, shard.last);
+
+	// both label lists are in ascending order
+	shard.local.assign(labels.size(), -1);
+	shard.global.assign(shard.index.labels.size(), -1);
+	int g = 0;
+	for (int d = 0; d < (int)shard.index.labels.size(); d++) {
+		while (labels[g] != shard.index.labels[d]) {
+			g++;
+		}
+		shard.local[g] = d;
+		shard.global[d] = g;
+	}
+
+	// incoming edges, by counting sort of the edges on their targets
+	int num_slots = shard.index.slot_node.size();
+	shard.reverse_begin.assign(num_slots + 1, 0);
+	shard.reverse_source.assign(shard.index.edge_target.size(), 0);
+	for (int e = 0; e < (int)shard.index.edge_target.size(); e++) {
+		shard.reverse_begin[shard.index.edge_target[e] + 1]++;
+	}
+	for (int v = 0; v < num_slots; v++) {
+		shard.reverse_begin[v + 1] += shard.reverse_begin[v];
+	}
+	vector<int> next(shard.reverse_begin.begin(), shard.reverse_begin.end() - 1);
+	for (int u = 0; u < num_slots; u++) {
+		for (int e = shard.index.edge_begin[u]; e < shard.index.edge_begin[u + 1]; e++) {
+			shard.reverse_source[next[shard.index.edge_target[e]]++] = u;
+		}
+	}
+
+	shard.covered.assign(num_slots, 0);
+	shard.mark.assign(num_slots, 0);
+	shard.invalid_stamp.assign(num_slots, 0);
+	prepare_scratch(shard.index, shard.scratch);
+	shard.cache.reset(new ReachCache(((size_t)max(PARAM_CACHE_MB, 0) << 20) / num_shards));
+
+}
+
+
+
+
+/*
+Function: cover_and_invalidate
+Input: lazy shard, int, int, traversal scratch, vector of ints
+Output: int
+
+Description: Covers the uncovered slots reachable from the given slot of the
+shard and returns their number (see cover_reach). Then walks the incoming
+edges back from the newly covered slots: exactly the nodes of the slots
+visited, the new seed included, reach a slot that is now covered, so their
+gains have shrunk. Their global dense ids are appended to invalidated, and
+the slots are stamped in invalid_stamp with stamp. Touches only the slots of
+the slot's cascade, so different cascades can be updated in parallel, each
+with its own scratch.
+*/
+int cover_and_invalidate(LazyShard& shard, int slot, int stamp, TraversalScratch& scratch, vector<int>& invalidated)
+{
+
+	int count = cover_reach(shard.index, shard.covered, slot, scratch);
+
+	if (count == 0) {
+		return 0;
+	}
+
+	vector<int>& queue = scratch.queue;
+	for (int v : queue) {
+		shard.invalid_stamp[v] = stamp;
+	}
+
+	for (int head = 0; head < (int)queue.size(); head++) {
+
+		int v = queue[head];
+
+		for (int e = shard.reverse_begin[v]; e < shard.reverse_begin[v + 1]; e++) {
+
+			int u = shard.reverse_source[e];
+
+			if (shard.invalid_stamp[u] != stamp) {
+				shard.invalid_stamp[u] = stamp;
+				queue.push_back(u);
+			}
+
+		}
+
+		invalidated.push_back(shard.global[shard.index.slot_node[v]]);
+
+	}
+
+	return count;
+
+}
+
+
+
+
+/*
+Function: lazy_greedy
+Input: vector of maps, int, bool, set of ints, lazy stats
+Output: long long
+
+Description: Runs the lazy greedy algorithm of Leskovec et al. (2007) for k
+iterations on the thread pool, adds the selected nodes to S, fills the stats
+and returns the sum over all cascades of the nodes the set reaches. Marginal
+gains only shrink as the seed set grows (influence is submodular), so a gain
+computed in an earlier iteration is an upper bound, and the node on top of
+the queue wins as soon as its gain is up to date. Stale entries are taken off
+the top of the queue in batches and re-evaluated together.
+
+The cascades are split into one contiguous shard per worker, balanced by
+size, and worker w evaluates every batch on shard w only; the partial gains
+are summed in shard order. If numa_local is set, each worker builds its own
+shard, so its pages land on the worker's NUMA node. Otherwise the calling
+thread builds all shards with their pages interleaved over the nodes. When
+PARAM_CACHE_MB is positive, each shard keeps its reach lists in its own
+ReachCache.
+
+With PARAM_SPECULATE set, the best up-to-date node of the iteration so far
+(the leader) is assumed to win. The slots it would cover are marked once,
+and every re-evaluated node also gets its gain for the next iteration against
+that speculated coverage. If the leader does win, the speculative gains enter
+the queue as up-to-date gains of the next iteration. If not, they are
+discarded. Selects the same set as main() either way.
+
+The coverage update after each selection runs in parallel over the cascades
+the winner appears in, and collects the nodes whose gains it invalidated
+(see cover_and_invalidate). Every other gain that was up to date stays up to
+date for the next iteration without being re-evaluated.
+
+The winner and the runners-up of each iteration are taken from the top of
+the queue (see IterationRanking) and added to the stats; runners-up are only
+listed while their gains are up to date, so ranking costs no evaluations.
+*/
+long long lazy_greedy(vector<map<int, vector<int> > >& cascades, int k, bool numa_local, set<int>& S, LazyStats& stats)
+{
+
+	static int build_tag = allocation_tag("LAZY GREEDY BUILD");
+	static int iterations_tag = allocation_tag("LAZY GREEDY ITERATIONS");
+	AllocationScope build_scope(build_tag);
+
+	auto build_start = chrono::high_resolution_clock::now();
+
+	int num_cascades = cascades.size();
+	int num_shards = thread_pool().size;
+
+	// collect the labels of all nodes in all cascades in ascending order;
+	// dense node ids follow this order, so ties go to the smaller node
+	vector<int> labels;
+	for (map<int, vector<int> >& A : cascades) {
+		for (auto& entry : A) {
+			labels.push_back(entry.first);
+			labels.insert(labels.end(), entry.second.begin(), entry.second.end());
+		}
+	}
+	sort(labels.begin(), labels.end());
+	labels.erase(unique(labels.begin(), labels.end()), labels.end());
+
+	int num_nodes = labels.size();
+
+	// cut the cascades into contiguous ranges of about equal size
+	long long total_size = 0;
+	for (map<int, vector<int> >& A : cascades) {
+		for (auto& entry : A) {
+			total_size += 1 + entry.second.size();
+		}
+	}
+
+	vector<LazyShard> shards(num_shards);
+	long long size = 0;
+	int c = 0;
+	for (int w = 0; w < num_shards; w++) {
+
+		shards[w].first = c;
+
+		while (c < num_cascades && (w == num_shards - 1 || size * num_shards < total_size * (w + 1))) {
+			for (auto& entry : cascades[c]) {
+				size += 1 + entry.second.size();
+			}
+			c++;
+		}
+
+		shards[w].last = c;
+
+	}
+
+	if (numa_local) {
+		for_each_worker([&](int w) {
+			build_lazy_shard(cascades, labels, num_shards, shards[w]);
+		});
+	}
+	else {
+		set_interleaved_placement(true);
+		for (LazyShard& shard : shards) {
+			build_lazy_shard(cascades, labels, num_shards, shard);
+		}
+		set_interleaved_placement(false);
+	}
+
+	for (LazyShard& shard : shards) {
+		stats.num_slots += shard.index.slot_node.size();
+		stats.shard_bytes += index_bytes(shard.index) + sizeof(int) * (shard.local.size() + shard.global.size()
+			+ shard.mark.size() + shard.scratch.stamp.size() + shard.reverse_begin.size() + shard.reverse_source.size()
+			+ shard.invalid_stamp.size()) + shard.covered.size();
+	}
+
+	auto greedy_start = chrono::high_resolution_clock::now();
+
+	AllocationScope iterations_scope(iterations_tag);
+
+	vector<char> chosen(num_nodes, 0);
+	long long total = 0;
+
+	// lazy queue of (upper bound on marginal gain, negated dense node id), so
+	// ties go to the smaller node as in main(); every node starts unbounded,
+	// or at the sum of its reach bounds if the pipelined load computed them.
+	// An entry whose gain is not the node's current bound is outdated.
+	priority_queue<pair<long long, int> > gains;
+	vector<long long> bound(num_nodes, LLONG_MAX);
+	vector<int> evaluated_at(num_nodes, -1);
+	if (&cascades == pipelined_cascades && pipelined_stats != NULL && (int)pipelined_index->labels.size() == num_nodes) {
+		CascadeIndex& loaded = *pipelined_index;
+		for (int d = 0; d < num_nodes; d++) {
+			bound[d] = num_cascades - (loaded.occurrence_begin[d + 1] - loaded.occurrence_begin[d]);
+			for (int o = loaded.occurrence_begin[d]; o < loaded.occurrence_begin[d + 1]; o++) {
+				bound[d] += pipelined_stats->reach_bound[loaded.occurrence_slot[o]];
+			}
+		}
+	}
+	for (int d = 0; d < num_nodes; d++) {
+		gains.push(make_pair(bound[d], -d));
+	}
+
+	// speculation: the slots the leader would cover are marked with mark_id
+	// in every shard, and each node's speculative gain remembers which leader
+	// it assumed
+	int mark_id = 0;
+	vector<long long> speculative_gain(num_nodes);
+	vector<int> speculative_leader(num_nodes, -1);
+	vector<int> speculated;
+
+	vector<int> batch;
+	vector<long long> partial_gain;
+	vector<long long> partial_speculative;
+
+	// coverage update: one task per (shard, slot) of the winner, with
+	// scratch space, gains and invalidated nodes per worker; fresh holds the
+	// nodes whose gains are up to date in the current iteration
+	vector<pair<int, int> > tasks;
+	vector<TraversalScratch> update_scratch(num_shards);
+	vector<long long> update_gain(num_shards);
+	vector<vector<int> > invalidated(num_shards);
+	vector<char> is_invalidated(num_nodes, 0);
+	vector<int> fresh;
+	vector<int> next_fresh;
+
+	// number of candidates ranked per iteration: the winner and the runners-up
+	int ranked = max(PARAM_RUNNERS_UP, 0) + 1;
+
+	// number of stale entries re-evaluated together; with PARAM_REPRODUCIBLE
+	// it does not depend on the number of threads, so neither do the
+	// evaluations made (nor the counters and rankings they lead to)
+	int batch_size = PARAM_REPRODUCIBLE ? PARAM_LAZY_BATCH : num_shards * PARAM_LAZY_BATCH;
+
+	// for k iterations corresponding to the k nodes to be selected, do
+	for (int iter = 0; iter < k; iter++) {
+
+		long long allocations = allocation_count();
+
+		for (LazyShard& shard : shards) {
+			shard.cache->hits = 0;
+			shard.cache->misses = 0;
+		}
+
+		int leader = -1;
+		speculated.clear();
+
+		while (true) {
+
+			// drop outdated entries from the top of the queue
+			while (!gains.empty() && (chosen[-gains.top().second] || gains.top().first != bound[-gains.top().second])) {
+				gains.pop();
+			}
+
+			if (gains.empty() || evaluated_at[-gains.top().second] == iter) {
+				break;
+			}
+
+			// take the stale entries off the top of the queue
+			batch.clear();
+			while (!gains.empty() && (int)batch.size() < batch_size) {
+
+				int d = -gains.top().second;
+
+				if (chosen[d] || gains.top().first != bound[d]) {
+					gains.pop();
+					continue;
+				}
+				if (evaluated_at[d] == iter) {
+					break;
+				}
+
+				batch.push_back(d);
+				gains.pop();
+
+			}
+
+			// recompute their gains against the current coverage (and the
+			// leader's speculated coverage), each worker on its own shard
+			int speculate_id = (PARAM_SPECULATE && leader != -1) ? mark_id : 0;
+			int b = batch.size();
+			partial_gain.assign(num_shards * b, 0);
+			partial_speculative.assign(num_shards * b, 0);
+
+			for_each_worker([&](int w) {
+
+				LazyShard& shard = shards[w];
+
+				for (int i = 0; i < b; i++) {
+
+					int d = shard.local[batch[i]];
+
+					// a node reaches itself in every cascade it does not appear in
+					if (d == -1) {
+						partial_gain[w * b + i] = shard.last - shard.first;
+						partial_speculative[w * b + i] = shard.last - shard.first;
+						continue;
+					}
+
+					lazy_gains(shard.index, shard.covered, shard.mark, speculate_id, d, shard.scratch, *shard.cache,
+						partial_gain[w * b + i], partial_speculative[w * b + i]);
+
+				}
+
+			});
+
+			for (int i = 0; i < b; i++) {
+
+				int d = batch[i];
+
+				long long gain = 0;
+				long long speculative = 0;
+				for (int w = 0; w < num_shards; w++) {
+					gain += partial_gain[w * b + i];
+					speculative += partial_speculative[w * b + i];
+				}
+
+				bound[d] = gain;
+				evaluated_at[d] = iter;
+				gains.push(make_pair(gain, -d));
+				fresh.push_back(d);
+
+				if (speculate_id != 0) {
+					speculative_gain[d] = speculative;
+					speculative_leader[d] = leader;
+					speculated.push_back(d);
+				}
+
+			}
+			stats.evaluations += b;
+
+			// find the new leader among the up-to-date gains
+			int previous = leader;
+			for (int d : batch) {
+				if (leader == -1 || bound[d] > bound[leader] || (bound[d] == bound[leader] && d < leader)) {
+					leader = d;
+				}
+			}
+
+			// mark the slots a new leader would cover
+			if (PARAM_SPECULATE && leader != previous) {
+
+				mark_id++;
+
+				for_each_worker([&](int w) {
+
+					LazyShard& shard = shards[w];
+					int d = shard.local[leader];
+
+					if (d == -1) {
+						return;
+					}
+
+					for (int o = shard.index.occurrence_begin[d]; o < shard.index.occurrence_begin[d + 1]; o++) {
+
+						int slot = shard.index.occurrence_slot[o];
+
+						if (shard.covered[slot] || shard.mark[slot] == mark_id) {
+							continue;
+						}
+
+						count_unmarked_reach(shard.index, shard.covered, shard.mark, mark_id, slot, shard.scratch);
+						for (int v : shard.scratch.queue) {
+							shard.mark[v] = mark_id;
+						}
+
+					}
+
+				});
+
+			}
+
+		}
+
+		if (gains.empty()) {
+			break;
+		}
+
+		// rank the winner and the runners-up from the top of the queue: entries
+		// up to date this iteration come off in order of their exact gains,
+		// and the first stale entry bounds the gains of all the others
+		IterationRanking ranking;
+		vector<pair<long long, int> > ranked_entries;
+		while (!gains.empty() && (int)ranking.top.size() < ranked) {
+
+			pair<long long, int> entry = gains.top();
+			int d = -entry.second;
+			gains.pop();
+
+			if (chosen[d] || entry.first != bound[d]) {
+				continue;
+			}
+
+			ranked_entries.push_back(entry);
+
+			if (evaluated_at[d] != iter) {
+				ranking.others_bound = (double)entry.first / num_cascades;
+				break;
+			}
+
+			ranking.top.push_back(make_pair(labels[d], (double)entry.first / num_cascades));
+
+		}
+		for (pair<long long, int>& entry : ranked_entries) {
+			gains.push(entry);
+		}
+		stats.rankings.push_back(ranking);
+
+		// the up-to-date gain on top of the queue beats every other bound, so
+		// add its node to the approximately optimal set
+		int winner = -gains.top().second;
+		gains.pop();
+
+		chosen[winner] = 1;
+		S.insert(labels[winner]);
+
+		// cover the winner's reach, one task per cascade it appears in; it
+		// reaches itself in every cascade it does not appear in
+		tasks.clear();
+		for (int w = 0; w < num_shards; w++) {
+
+			LazyShard& shard = shards[w];
+			int d = shard.local[winner];
+
+			if (d == -1) {
+				total += shard.last - shard.first;
+				continue;
+			}
+
+			total += (shard.last - shard.first) - (shard.index.occurrence_begin[d + 1] - shard.index.occurrence_begin[d]);
+			for (int o = shard.index.occurrence_begin[d]; o < shard.index.occurrence_begin[d + 1]; o++) {
+				tasks.push_back(make_pair(w, shard.index.occurrence_slot[o]));
+			}
+
+		}
+
+		for (int w = 0; w < num_shards; w++) {
+			update_gain[w] = 0;
+			invalidated[w].clear();
+		}
+
+		parallel_for(tasks.size(), [&](int worker, int i) {
+			update_gain[worker] += cover_and_invalidate(shards[tasks[i].first], tasks[i].second, iter + 1,
+				update_scratch[worker], invalidated[worker]);
+		});
+
+		for (int w = 0; w < num_shards; w++) {
+			total += update_gain[w];
+			for (int d : invalidated[w]) {
+				stats.invalidated += !is_invalidated[d];
+				is_invalidated[d] = 1;
+			}
+		}
+
+		// speculative gains that assumed the winner are the next iteration's
+		// up-to-date gains; the others are discarded
+		next_fresh.clear();
+		for (int d : speculated) {
+
+			if (chosen[d] || speculative_leader[d] != winner) {
+				stats.speculation_discarded++;
+				continue;
+			}
+
+			stats.speculation_used++;
+			evaluated_at[d] = iter + 1;
+			next_fresh.push_back(d);
+
+			if (speculative_gain[d] != bound[d]) {
+				bound[d] = speculative_gain[d];
+				gains.push(make_pair(bound[d], -d));
+			}
+
+		}
+
+		// the other up-to-date gains the winner did not invalidate are still
+		// exact, so they stay up to date in the next iteration
+		for (int d : fresh) {
+			if (!chosen[d] && evaluated_at[d] == iter && !is_invalidated[d]) {
+				evaluated_at[d] = iter + 1;
+				next_fresh.push_back(d);
+				stats.gains_kept++;
+			}
+		}
+		fresh.swap(next_fresh);
+
+		for (int w = 0; w < num_shards; w++) {
+			for (int d : invalidated[w]) {
+				is_invalidated[d] = 0;
+			}
+		}
+
+		long long hits = 0;
+		long long lookups = 0;
+		for (LazyShard& shard : shards) {
+			hits += shard.cache->hits;
+			lookups += shard.cache->hits + shard.cache->misses;
+		}
+		stats.hit_rates.push_back(lookups == 0 ? 0.0 : (double)hits / lookups);
+
+		stats.iteration_allocations.push_back(allocation_count() - allocations);
+
+	}
+
+	auto end = chrono::high_resolution_clock::now();
+
+	stats.num_nodes = num_nodes;
+	stats.build_seconds = chrono::duration<double>(greedy_start - build_start).count();
+	stats.greedy_seconds = chrono::duration<double>(end - greedy_start).count();
+
+	return total;
+
+}
+
+
+
+
+/*
+Function: run_lazy_greedy
+Input: vector of maps, vector of strings
+Output: none
+
+Description: Runs lazy_greedy for PARAM_K iterations with the placement given
+by PARAM_NUMA_LOCAL and prints its result. When PARAM_CACHE_MB is positive,
+the hit rate of the reach caches is printed for every iteration. The seeds'
+reach is then attributed (see attribute_seeds) if ATTRIBUTION_FILE is set.
+*/
+void run_lazy_greedy(vector<map<int, vector<int> > >& cascades, vector<string>& cascade_names)
+{
+
+	if (PARAM_REPRODUCIBLE) {
+		cout << endl << "RUNNING LAZY GREEDY ALGORITHM..." << endl;
+	}
+	else {
+		cout << endl << "RUNNING LAZY GREEDY ALGORITHM ON " << to_string(thread_pool().size) << " THREADS..." << endl;
+	}
+
+	auto start = chrono::high_resolution_clock::now();
+
+	set<int> S;
+	LazyStats stats;
+	long long total = lazy_greedy(cascades, PARAM_K, PARAM_NUMA_LOCAL, S, stats);
+
+	// each thread's cache gets its share of PARAM_CACHE_MB, so hit rates
+	// depend on the number of threads
+	if (PARAM_CACHE_MB > 0 && !PARAM_REPRODUCIBLE) {
+		cout << endl << "REACH CACHE HIT RATE PER ITERATION:";
+		for (double rate : stats.hit_rates) {
+			cout << " " << to_string(rate);
+		}
+		cout << endl;
+	}
+
+	if (PARAM_SPECULATE) {
+		cout << endl << "SPECULATIVE GAINS USED: " << to_string(stats.speculation_used) << " DISCARDED: " << to_string(stats.speculation_discarded) << endl;
+	}
+
+	cout << endl << "MARGINAL GAIN EVALUATIONS: " << to_string(stats.evaluations) << " (FULL SCANS WOULD NEED "
+		<< to_string((long long)stats.num_nodes * S.size()) << ")" << endl;
+	cout << "GAINS INVALIDATED BY SELECTIONS: " << to_string(stats.invalidated) << " KEPT UP TO DATE: " << to_string(stats.gains_kept) << endl;
+
+	print_rankings(stats.rankings);
+
+	if (!CURVE_FILE.empty()) {
+		write_curve(stats.rankings);
+	}
+
+	if (PARAM_TRACK_ALLOCATIONS) {
+		cout << endl << "ALLOCATIONS PER ITERATION:";
+		for (long long allocations : stats.iteration_allocations) {
+			cout << " " << to_string(allocations);
+		}
+		cout << endl;
+	}
+
+	print_result(S, (double)total / cascades.size(), start);
+
+	if (!ATTRIBUTION_FILE.empty()) {
+		attribute_seeds(cascades, cascade_names, S);
+	}
+
+}
+
+
+
+
+/*
+Structure: DtlbCounter
+Description: Counts the dTLB load misses of all worker threads of the thread
+			 pool between start() and stop(), with one perf_event_open
+			 counter per worker. stop() returns -1 if the counters are not
+			 available (e.g. no permission or no such hardware event).
+*/
+struct DtlbCounter
+{
+
+	vector<int> fds;
+
+	void start()
+	{
+
+		fds.assign(thread_pool().size, -1);
+
+		// each worker opens a counter for itself
+		for_each_worker([&](int w) {
+
+			perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = PERF_TYPE_HW_CACHE;
+			attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+
+			fds[w] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+
+		});
+
+	}
+
+	long long stop()
+	{
+
+		long long misses = 0;
+
+		for (int fd : fds) {
+
+			long long count = 0;
+
+			if (fd == -1 || read(fd, &count, sizeof(count)) != sizeof(count)) {
+				misses = -1;
+			}
+			else if (misses != -1) {
+				misses += count;
+			}
+
+			if (fd != -1) {
+				close(fd);
+			}
+
+		}
+
+		fds.clear();
+
+		return misses;
+
+	}
+
+};
+
+
+
+
+/*
+Function: run_benchmark
+Input: vector of maps
+Output: none
+
+Description: Runs lazy_greedy PARAM_BENCHMARK_REPEATS times in each
+configuration: with the cascades interleaved over the NUMA nodes or local to
+the node of the worker that evaluates them, each with the flat arrays backed
+by ordinary pages and by huge pages (as set by PARAM_HUGE_PAGES, or
+transparent huge pages if it is HUGE_PAGES_OFF). Prints the time to build
+the shards and to run the greedy and the dTLB load misses of each run, and
+the fastest run of each configuration.
+*/
+void run_benchmark(vector<map<int, vector<int> > >& cascades)
+{
+
+	ThreadPool& pool = thread_pool();
+
+	cout << endl << "RUNNING PLACEMENT BENCHMARK ON " << to_string(pool.size) << " THREADS AND "
+		<< to_string(pool.node_ids.size()) << " NUMA NODES"
+		<< (PARAM_PIN_THREADS ? " (PINNED)" : " (NOT PINNED)") << "..." << endl;
+
+	int huge = PARAM_HUGE_PAGES == HUGE_PAGES_OFF ? HUGE_PAGES_TRANSPARENT : PARAM_HUGE_PAGES;
+
+	// configurations of (placement is local, huge page setting)
+	vector<pair<bool, int> > configurations = {
+		make_pair(false, HUGE_PAGES_OFF), make_pair(true, HUGE_PAGES_OFF),
+		make_pair(false, huge), make_pair(true, huge)
+	};
+
+	int n = configurations.size();
+	vector<string> names(n);
+	vector<double> best_build(n, 0);
+	vector<double> best_greedy(n, 0);
+	vector<long long> best_misses(n, -1);
+	vector<set<int> > seeds(n);
+
+	for (int i = 0; i < n; i++) {
+		names[i] = string(configurations[i].first ? "LOCAL" : "INTERLEAVED") + ", "
+			+ (configurations[i].second == HUGE_PAGES_OFF ? "SMALL PAGES" :
+			   configurations[i].second == HUGE_PAGES_TRANSPARENT ? "TRANSPARENT HUGE PAGES" : "RESERVED HUGE PAGES");
+	}
+
+	for (int repeat = 0; repeat < PARAM_BENCHMARK_REPEATS; repeat++) {
+		for (int i = 0; i < n; i++) {
+
+			use_huge_pages = configurations[i].second;
+
+			set<int> S;
+			LazyStats stats;
+			DtlbCounter counter;
+
+			counter.start();
+			long long total = lazy_greedy(cascades, PARAM_K, configurations[i].first, S, stats);
+			long long misses = counter.stop();
+
+			cout << names[i] << " RUN " << to_string(repeat + 1) << ": BUILD " << to_string(stats.build_seconds)
+				<< " SECONDS, GREEDY " << to_string(stats.greedy_seconds) << " SECONDS, DTLB MISSES "
+				<< (misses == -1 ? string("n/a") : to_string(misses)) << ", INFLUENCE "
+				<< to_string((double)total / cascades.size());
+			if (PARAM_TRACK_ALLOCATIONS) {
+				cout << ", ALLOCATIONS IN ITERATIONS "
+					<< to_string(accumulate(stats.iteration_allocations.begin(), stats.iteration_allocations.end(), 0LL));
+			}
+			cout << endl;
+
+			if (repeat == 0 || stats.build_seconds < best_build[i]) {
+				best_build[i] = stats.build_seconds;
+			}
+			if (repeat == 0 || stats.greedy_seconds < best_greedy[i]) {
+				best_greedy[i] = stats.greedy_seconds;
+			}
+			if (misses != -1 && (best_misses[i] == -1 || misses < best_misses[i])) {
+				best_misses[i] = misses;
+			}
+			seeds[i] = S;
+
+		}
+	}
+
+	use_huge_pages = PARAM_HUGE_PAGES;
+
+	cout << endl << "FASTEST RUNS (FEWEST DTLB MISSES):" << endl;
+	for (int i = 0; i < n; i++) {
+		cout << names[i] << ": BUILD " << to_string(best_build[i]) << " SECONDS, GREEDY "
+			<< to_string(best_greedy[i]) << " SECONDS, DTLB MISSES "
+			<< (best_misses[i] == -1 ? string("n/a") : to_string(best_misses[i])) << endl;
+	}
+
+	for (int i = 1; i < n; i++) {
+		if (seeds[i] != seeds[0]) {
+			cout << endl << "WARNING: THE CONFIGURATIONS SELECTED DIFFERENT SETS" << endl;
+			break;
+		}
+	}
+
+}
+
+
+
+
+
+/*
+Function: last_level_cache_bytes
+Input: none
+Output: size_t
+
+Description: Returns the size of the largest cache of the first CPU, as listed
+in /sys/devices/system/cpu/cpu0/cache, or 8 MB if none is listed.
+*/
+size_t last_level_cache_bytes()
+{
+
+	size_t largest = 0;
+
+	error_code error;
+	for (auto entry : filesystem::directory_iterator("/sys/devices/system/cpu/cpu0/cache", error)) {
+
+		// sizes are given as e.g. "32768K"
+		ifstream infile((entry.path() / "size").string().c_str());
+		string size;
+
+		if (!(infile >> size) || size.empty()) {
+			continue;
+		}
+
+		size_t bytes = stoull(size);
+		if (size.back() == 'K') {
+			bytes <<= 10;
+		}
+		else if (size.back() == 'M') {
+			bytes <<= 20;
+		}
+
+		largest = max(largest, bytes);
+
+	}
+
+	return largest == 0 ? (size_t)8 << 20 : largest;
+
+}
+
+
+
+
+/*
+Function: generate_cascade_index
+Input: int, int, random number generator, cascade index
+Output: none
+
+Description: Fills the cascade index with count random cascades over the nodes
+0 to size - 1. Each cascade is a random recursive tree: the nodes join in the
+order 0, 1, ..., and each node after node 0 is infected by a uniformly random
+node that joined before it, so node 0 reaches the whole cascade and early
+nodes reach large parts of it. The slots of each cascade are shuffled, so
+searches jump around its arrays as they would in a large real cascade.
+Builds the index directly, without the maps of the loader, so that
+cascades much larger than the last level cache fit in memory.
+*/
+void generate_cascade_index(int count, int size, mt19937& rng, CascadeIndex& index)
+{
+
+	long long num_slots = (long long)count * size;
+
+	index = CascadeIndex();
+	index.labels.resize(size);
+	index.cascade_begin.resize(count + 1);
+	index.slot_cascade.resize(num_slots);
+	index.slot_node.resize(num_slots);
+	index.edge_begin.assign(num_slots + 1, 0);
+	index.edge_target.resize(num_slots - count);
+	index.occurrence_begin.resize(size + 1);
+	index.occurrence_slot.resize(num_slots);
+
+	for (int d = 0; d < size; d++) {
+		index.labels[d] = d;
+	}
+
+	vector<int> node_slot(size);
+	vector<int> parent(size);
+	vector<int> next_edge;
+
+	for (int c = 0; c < count; c++) {
+
+		int first = c * size;
+		index.cascade_begin[c] = first;
+
+		for (int d = 0; d < size; d++) {
+			node_slot[d] = first + d;
+		}
+		shuffle(node_slot.begin(), node_slot.end(), rng);
+
+		for (int d = 0; d < size; d++) {
+			index.slot_cascade[node_slot[d]] = c;
+			index.slot_node[node_slot[d]] = d;
+			index.occurrence_slot[(long long)d * count + c] = node_slot[d];
+		}
+
+		// count the edges out of each slot, then place them
+		for (int d = 1; d < size; d++) {
+			parent[d] = uniform_int_distribution<int>(0, d - 1)(rng);
+			index.edge_begin[node_slot[parent[d]] + 1]++;
+		}
+
+		for (int slot = first; slot < first + size; slot++) {
+			index.edge_begin[slot + 1] += index.edge_begin[slot];
+		}
+
+		next_edge.assign(index.edge_begin.begin() + first, index.edge_begin.begin() + first + size);
+
+		for (int d = 1; d < size; d++) {
+			int u = node_slot[parent[d]] - first;
+			index.edge_target[next_edge[u]++] = node_slot[d];
+		}
+
+	}
+
+	index.cascade_begin[count] = num_slots;
+
+	for (int d = 0; d <= size; d++) {
+		index.occurrence_begin[d] = (long long)d * count;
+	}
+
+}
+
+
+
+
+/*
+Function: run_prefetch_benchmark
+Input: none
+Output: none
+
+Description: Measures the effect of prefetching on the breadth-first searches
+of the greedy algorithm. Generates one cascade whose arrays fit in a quarter
+of the last level cache and one PARAM_PREFETCH_ABOVE_LLC times larger than
+it, and times the marginal gains of their 64 earliest nodes with a range of
+prefetch distances (the fastest of PARAM_BENCHMARK_REPEATS runs each).
+*/
+void run_prefetch_benchmark()
+{
+
+	size_t llc = last_level_cache_bytes();
+
+	cout << endl << "RUNNING PREFETCH BENCHMARK (LAST LEVEL CACHE " << to_string(llc >> 20) << " MB)..." << endl;
+
+	// bytes each slot takes in the arrays a search reads and writes: the
+	// cascade index, the search stamp, the coverage flag and the queue
+	const size_t slot_bytes = 6 * sizeof(int) + sizeof(char);
+	const int queries = 64;
+	const int distances[] = {0, 2, 4, 8, 16, 32, 64};
+
+	vector<pair<string, size_t> > sizes = {
+		make_pair("BELOW", llc / 4 / slot_bytes),
+		make_pair("ABOVE", llc * PARAM_PREFETCH_ABOVE_LLC / slot_bytes)
+	};
+
+	mt19937 rng(PARAM_RANDOM_SEED);
+
+	for (auto& size : sizes) {
+
+		int num_slots = min(size.second, (size_t)INT_MAX / 2);
+
+		CascadeIndex index;
+		generate_cascade_index(1, num_slots, rng, index);
+
+		FlatFlags covered(num_slots, 0);
+		TraversalScratch scratch;
+		prepare_scratch(index, scratch);
+
+		cout << endl << "CASCADE OF " << to_string(num_slots) << " NODES (" << to_string(num_slots * slot_bytes >> 20)
+			<< " MB, " << size.first << " THE LAST LEVEL CACHE):" << endl;
+
+		double baseline = 0;
+		long long expected = -1;
+
+		for (int distance : distances) {
+
+			prefetch_distance = distance;
+
+			double best = 0;
+			long long total = 0;
+
+			for (int repeat = 0; repeat < PARAM_BENCHMARK_REPEATS; repeat++) {
+
+				auto start = chrono::high_resolution_clock::now();
+
+				total = 0;
+				for (int d = 0; d < queries; d++) {
+					total += marginal_gain(index, covered, d, scratch);
+				}
+
+				double seconds = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+
+				if (repeat == 0 || seconds < best) {
+					best = seconds;
+				}
+
+			}
+
+			if (distance == 0) {
+				baseline = best;
+				expected = total;
+			}
+
+			cout << "PREFETCH DISTANCE " << to_string(distance) << ": " << to_string(best) << " SECONDS, "
+				<< to_string(total / best / 1e6) << " MILLION NODES PER SECOND, SPEEDUP " << to_string(baseline / best)
+				<< (total != expected ? " (WRONG TOTAL)" : "") << endl;
+
+		}
+
+	}
+
+	prefetch_distance = PARAM_PREFETCH_DISTANCE;
+
+}
+
+
+
+
+
+/*
+Cascade storage backends
+
+The functions store_reachable_from and store_influence below are templates
+over the type of cascade storage, so each backend gets its own compiled copy
+of the traversal with no virtual calls in the inner loop. A storage type
+provides:
+
+	int num_cascades()           number of cascades
+	int num_ids()                the nodes of all cascades have the ids 0 to
+	                             num_ids() - 1
+	int find(int c, int label)   id of the node with the label in cascade c,
+	                             or -1 if the node is not in the cascade
+	int label(int id)            label of the node with the id
+	neighbors(int id)            ids of the nodes the node infected, as a range
+	                             usable in a range-based for loop
+	size_t bytes()               memory used by the storage
+
+The traversals of the coverage-based engines (collect_reach,
+count_uncovered_reach, cover_reach, marginal_gain, add_seed and the weighted
+greedy algorithm) are templates over the same concept, with ids as slots,
+and also need:
+
+	int num_nodes()              number of distinct labels
+	int cascade(int id)          cascade of the id
+	occurrences(int d)           ids of the node with the d-th smallest label,
+	                             in ascending order of cascade, as a range
+
+CascadeIndex and CsrStore provide these, so those engines run unchanged on a
+store mapped from a file.
+
+Backends: CsrStore (the arrays of a CascadeIndex, on the heap or mapped from
+a file), CompressedStore (adjacency lists delta and varint encoded) and
+TreeStore (cascades that are forests, numbered in preorder, with an
+overload of store_reachable_from that needs no search at all).
+*/
+
+
+
+
+/*
+Function: find_node
+Input: pointers to ints, int, int, int
+Output: int
+
+Description: Shared lookup of the storage backends. Given the labels of all
+nodes in ascending order, the ids of each node's occurrences in ascending
+order of cascade (grouped by occurrence_begin) and the cascade of each id,
+returns the id of the node with the label in cascade c, or -1.
+*/
+inline int find_node(const int* labels, int label_count, const int* occurrence_begin, const int* occurrence_id,
+	const int* id_cascade, int c, int label)
+{
+
+	int d = lower_bound(labels, labels + label_count, label) - labels;
+
+	if (d == label_count || labels[d] != label) {
+		return -1;
+	}
+
+	const int* first = occurrence_id + occurrence_begin[d];
+	const int* last = occurrence_id + occurrence_begin[d + 1];
+	const int* found = lower_bound(first, last, c, [&](int id, int cascade) { return id_cascade[id] < cascade; });
+
+	return (found != last && id_cascade[*found] == c) ? *found : -1;
+
+}
+
+
+
+
+/*
+Structure: CsrStore
+Description: Storage backend over the arrays of a cascade index: ids are
+			 slots. The arrays are either those of a CascadeIndex in memory
+			 (see csr_store) or a file written by write_csr_store and mapped
+			 read-only into memory (see map_csr_store), in which case the
+			 mapping is released with the store.
+*/
+struct CsrStore
+{
+
+	int label_count = 0;
+	int cascade_count = 0;
+	int id_count = 0;
+	long long edge_count = 0;
+
+	const int* labels = NULL;
+	const int* id_cascade = NULL;
+	const int* id_node = NULL;
+	const int* edge_begin = NULL;
+	const int* edge_target = NULL;
+	const int* occurrence_begin = NULL;
+	const int* occurrence_id = NULL;
+
+	// file mapping holding the arrays, if any
+	void* mapping = NULL;
+	size_t mapping_bytes = 0;
+
+	CsrStore() {}
+	CsrStore(const CsrStore&) = delete;
+	CsrStore& operator=(const CsrStore&) = delete;
+
+	~CsrStore()
+	{
+		if (mapping != NULL) {
+			munmap(mapping, mapping_bytes);
+		}
+	}
+
+	int num_cascades() { return cascade_count; }
+	int num_ids() { return id_count; }
+	int num_nodes() { return label_count; }
+	int label(int id) { return labels[id_node[id]]; }
+	int cascade(int id) { return id_cascade[id]; }
+	IdRange neighbors(int id) { return IdRange{edge_target + edge_begin[id], edge_target + edge_begin[id + 1]}; }
+	IdRange occurrences(int d) { return IdRange{occurrence_id + occurrence_begin[d], occurrence_id + occurrence_begin[d + 1]}; }
+
+	int find(int c, int label)
+	{
+		return find_node(labels, label_count, occurrence_begin, occurrence_id, id_cascade, c, label);
+	}
+
+	size_t bytes()
+	{
+		return sizeof(int) * ((size_t)label_count * 2 + 1 + (size_t)id_count * 4 + 1 + edge_count);
+	}
+
+};
+
+
+
+
+/*
+Function: csr_store
+Input: cascade index, CSR store
+Output: none
+
+Description: Points the CSR store at the arrays of the cascade index, which
+must outlive it.
+*/
+void csr_store(CascadeIndex& index, CsrStore& store)
+{
+
+	store.label_count = index.labels.size();
+	store.cascade_count = index.cascade_begin.size() - 1;
+	store.id_count = index.slot_node.size();
+	store.edge_count = index.edge_target.size();
+
+	store.labels = index.labels.data();
+	store.id_cascade = index.slot_cascade.data();
+	store.id_node = index.slot_node.data();
+	store.edge_begin = index.edge_begin.data();
+	store.edge_target = index.edge_target.data();
+	store.occurrence_begin = index.occurrence_begin.data();
+	store.occurrence_id = index.occurrence_slot.data();
+
+}
+
+
+
+
+/*
+Function: write_csr_store
+Input: cascade index, string
+Output: bool
+
+Description: Writes the arrays of the cascade index to a binary file: the
+numbers of labels, cascades, slots and edges as 64-bit integers, then
+labels, slot_cascade, slot_node, edge_begin, edge_target, occurrence_begin
+and occurrence_slot as 32-bit integers. Returns false if the file cannot be
+written.
+*/
+bool write_csr_store(CascadeIndex& index, string path)
+{
+
+	ofstream outfile(path.c_str(), ios::binary | ios::trunc);
+
+	long long counts[4] = {(long long)index.labels.size(), (long long)index.cascade_begin.size() - 1,
+		(long long)index.slot_node.size(), (long long)index.edge_target.size()};
+	outfile.write((const char*)counts, sizeof(counts));
+
+	outfile.write((const char*)index.labels.data(), index.labels.size() * sizeof(int));
+	outfile.write((const char*)index.slot_cascade.data(), index.slot_cascade.size() * sizeof(int));
+	outfile.write((const char*)index.slot_node.data(), index.slot_node.size() * sizeof(int));
+	outfile.write((const char*)index.edge_begin.data(), index.edge_begin.size() * sizeof(int));
+	outfile.write((const char*)index.edge_target.data(), index.edge_target.size() * sizeof(int));
+	outfile.write((const char*)index.occurrence_begin.data(), index.occurrence_begin.size() * sizeof(int));
+	outfile.write((const char*)index.occurrence_slot.data(), index.occurrence_slot.size() * sizeof(int));
+
+	return outfile.good();
+
+}
+
+
+
+
+/*
+Function: map_csr_store
+Input: string, CSR store
+Output: bool
+
+Description: Maps a file written by write_csr_store read-only into memory and
+points the CSR store at its arrays. Returns false, with nothing left mapped, if
+the file cannot be mapped or is shorter than the arrays its header announces
+(a truncated or damaged file).
+*/
+bool map_csr_store(string path, CsrStore& store)
+{
+
+	int fd = open(path.c_str(), O_RDONLY);
+
+	if (fd == -1) {
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size < (off_t)(4 * sizeof(long long))) {
+		close(fd);
+		return false;
+	}
+
+	void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mapping == MAP_FAILED) {
+		return false;
+	}
+
+	const long long* counts = (const long long*)mapping;
+
+	// labels, slot cascades, slot nodes, edge offsets, edge targets,
+	// occurrence offsets and occurrence slots, in this order
+	bool valid = counts[0] >= 0 && counts[1] >= 0 && counts[2] >= 0 && counts[3] >= 0
+		&& counts[0] < INT_MAX && counts[2] < INT_MAX && counts[3] < INT_MAX;
+	long long ints = valid ? 2 * counts[0] + 4 * counts[2] + counts[3] + 2 : 0;
+
+	if (!valid || info.st_size < (off_t)(4 * sizeof(long long) + ints * sizeof(int))) {
+		munmap(mapping, info.st_size);
+		return false;
+	}
+
+	const int* p = (const int*)(counts + 4);
+
+	store.mapping = mapping;
+	store.mapping_bytes = info.st_size;
+	store.label_count = counts[0];
+	store.cascade_count = counts[1];
+	store.id_count = counts[2];
+	store.edge_count = counts[3];
+
+	store.labels = p;
+	p += store.label_count;
+	store.id_cascade = p;
+	p += store.id_count;
+	store.id_node = p;
+	p += store.id_count;
+	store.edge_begin = p;
+	p += store.id_count + 1;
+	store.edge_target = p;
+	p += store.edge_count;
+	store.occurrence_begin = p;
+	p += store.label_count + 1;
+	store.occurrence_id = p;
+
+	return true;
+
+}
+
+
+
+
+/*
+Structure: VarintRange
+Description: Range of ids stored as a delta and varint encoded byte string
+			 (see CompressedStore), decoded while it is iterated.
+*/
+struct VarintRange
+{
+
+	const unsigned char* first;
+	const unsigned char* last;
+	int base;
+
+	struct iterator
+	{
+
+		// start of the current value, end of its bytes, and the value
+		const unsigned char* at;
+		const unsigned char* next;
+		const unsigned char* last;
+		int value;
+
+		void decode(int previous)
+		{
+
+			unsigned zigzag = 0;
+			int shift = 0;
+
+			next = at;
+			while (*next & 0x80) {
+				zigzag |= (unsigned)(*next++ & 0x7f) << shift;
+				shift += 7;
+			}
+			zigzag |= (unsigned)*next++ << shift;
+
+			value = previous + (int)((zigzag >> 1) ^ -(zigzag & 1));
+
+		}
+
+		int operator*() const { return value; }
+		bool operator!=(const iterator& other) const { return at != other.at; }
+
+		iterator& operator++()
+		{
+			at = next;
+			if (at != last) {
+				decode(value);
+			}
+			return *this;
+		}
+
+	};
+
+	iterator begin() const
+	{
+		iterator it{first, first, last, base};
+		if (first != last) {
+			it.decode(base);
+		}
+		return it;
+	}
+
+	iterator end() const
+	{
+		return iterator{last, last, last, 0};
+	}
+
+};
+
+
+
+
+/*
+Structure: CompressedStore
+Description: Storage backend with the ids of a cascade index and compressed
+			 adjacency lists: each list is sorted, and every id is stored as
+			 its difference to the previous id (to the node's own id for the
+			 first) in zigzag varint encoding, which takes one byte for
+			 nearby ids. Lists must fit in 4 GB in total.
+*/
+struct CompressedStore
+{
+
+	int cascade_count = 0;
+	vector<int> labels;
+	FlatInts id_cascade;
+	FlatInts id_node;
+	FlatInts occurrence_begin;
+	FlatInts occurrence_id;
+
+	// id -> first byte of its list (plus one entry past the end), and the lists
+	vector<unsigned> edge_offset;
+	vector<unsigned char> edges;
+
+	int num_cascades() { return cascade_count; }
+	int num_ids() { return id_node.size(); }
+	int label(int id) { return labels[id_node[id]]; }
+	VarintRange neighbors(int id) { return VarintRange{edges.data() + edge_offset[id], edges.data() + edge_offset[id + 1], id}; }
+
+	int find(int c, int label)
+	{
+		return find_node(labels.data(), labels.size(), occurrence_begin.data(), occurrence_id.data(), id_cascade.data(), c, label);
+	}
+
+	size_t bytes()
+	{
+		return sizeof(int) * (labels.size() + id_cascade.size() + id_node.size() + occurrence_begin.size() + occurrence_id.size())
+			+ sizeof(unsigned) * edge_offset.size() + edges.size();
+	}
+
+};
+
+
+
+
+/*
+Function: build_compressed_store
+Input: cascade index, compressed store
+Output: none
+
+Description: Fills the compressed store with the cascades of the cascade index.
+*/
+void build_compressed_store(CascadeIndex& index, CompressedStore& store)
+{
+
+	store.cascade_count = index.cascade_begin.size() - 1;
+	store.labels = index.labels;
+	store.id_cascade = index.slot_cascade;
+	store.id_node = index.slot_node;
+	store.occurrence_begin = index.occurrence_begin;
+	store.occurrence_id = index.occurrence_slot;
+
+	store.edge_offset.assign(1, 0);
+	store.edges.clear();
+
+	vector<int> targets;
+	for (int slot = 0; slot < (int)index.slot_node.size(); slot++) {
+
+		targets.assign(index.edge_target.begin() + index.edge_begin[slot], index.edge_target.begin() + index.edge_begin[slot + 1]);
+		sort(targets.begin(), targets.end());
+
+		int previous = slot;
+		for (int v : targets) {
+
+			int delta = v - previous;
+			unsigned zigzag = ((unsigned)delta << 1) ^ (unsigned)(delta >> 31);
+
+			while (zigzag >= 0x80) {
+				store.edges.push_back((zigzag & 0x7f) | 0x80);
+				zigzag >>= 7;
+			}
+			store.edges.push_back(zigzag);
+
+			previous = v;
+
+		}
+
+		store.edge_offset.push_back(store.edges.size());
+
+	}
+
+}
+
+
+
+
+/*
+Structure: TreeStore
+Description: Storage backend for cascades that are forests (every node was
+			 infected by at most one node), as most observed cascades are.
+			 The nodes of each cascade are numbered in depth-first preorder,
+			 so the nodes a node reaches are exactly the ids from the node's
+			 id to id + subtree_size - 1, and no search is needed (see the
+			 overload of store_reachable_from).
+*/
+struct TreeStore
+{
+
+	int cascade_count = 0;
+	vector<int> labels;
+	FlatInts id_cascade;
+	FlatInts id_node;
+	FlatInts subtree_size;
+	FlatInts child_begin;
+	FlatInts child;
+	FlatInts occurrence_begin;
+	FlatInts occurrence_id;
+
+	int num_cascades() { return cascade_count; }
+	int num_ids() { return id_node.size(); }
+	int label(int id) { return labels[id_node[id]]; }
+	IdRange neighbors(int id) { return IdRange{child.data() + child_begin[id], child.data() + child_begin[id + 1]}; }
+
+	int find(int c, int label)
+	{
+		return find_node(labels.data(), labels.size(), occurrence_begin.data(), occurrence_id.data(), id_cascade.data(), c, label);
+	}
+
+	size_t bytes()
+	{
+		return sizeof(int) * (labels.size() + id_cascade.size() + id_node.size() + subtree_size.size() + child_begin.size()
+			+ child.size() + occurrence_begin.size() + occurrence_id.size());
+	}
+
+};
+
+
+
+
+/*
+Function: build_tree_store
+Input: cascade index, tree store
+Output: bool
+
+Description: Fills the tree store with the cascades of the cascade index.
+Returns false, leaving the store unusable, if some cascade is not a forest.
+*/
+bool build_tree_store(CascadeIndex& index, TreeStore& store)
+{
+
+	int num_slots = index.slot_node.size();
+
+	// every slot may have at most one incoming edge
+	vector<int> in_degree(num_slots, 0);
+	for (int v : index.edge_target) {
+		if (++in_degree[v] > 1) {
+			return false;
+		}
+	}
+
+	store.cascade_count = index.cascade_begin.size() - 1;
+	store.labels = index.labels;
+	store.id_cascade.resize(num_slots);
+	store.id_node.resize(num_slots);
+	store.subtree_size.assign(num_slots, 1);
+
+	// number the slots of each cascade in preorder, starting from its roots
+	vector<int> slot_id(num_slots, -1);
+	vector<int> id_slot(num_slots);
+	vector<pair<int, int> > stack;
+	int next_id = 0;
+
+	for (int c = 0; c < store.cascade_count; c++) {
+		for (int root = index.cascade_begin[c]; root < index.cascade_begin[c + 1]; root++) {
+
+			if (in_degree[root] != 0) {
+				continue;
+			}
+
+			// stack of (slot, id); children are pushed in reverse so they are
+			// numbered in order
+			stack.push_back(make_pair(root, -1));
+
+			while (!stack.empty()) {
+
+				int u = stack.back().first;
+				stack.pop_back();
+
+				int id = next_id++;
+				slot_id[u] = id;
+				id_slot[id] = u;
+				store.id_cascade[id] = c;
+				store.id_node[id] = index.slot_node[u];
+
+				for (int e = index.edge_begin[u + 1] - 1; e >= index.edge_begin[u]; e--) {
+					stack.push_back(make_pair(index.edge_target[e], id));
+				}
+
+			}
+
+		}
+	}
+
+	// slots left unnumbered lie on a cycle
+	if (next_id != num_slots) {
+		return false;
+	}
+
+	// subtree sizes, children last: in preorder every child comes after its parent
+	for (int id = num_slots - 1; id >= 0; id--) {
+		int u = id_slot[id];
+		for (int e = index.edge_begin[u]; e < index.edge_begin[u + 1]; e++) {
+			store.subtree_size[id] += store.subtree_size[slot_id[index.edge_target[e]]];
+		}
+	}
+
+	store.child_begin.assign(1, 0);
+	store.child.clear();
+	for (int id = 0; id < num_slots; id++) {
+		int u = id_slot[id];
+		for (int e = index.edge_begin[u]; e < index.edge_begin[u + 1]; e++) {
+			store.child.push_back(slot_id[index.edge_target[e]]);
+		}
+		store.child_begin.push_back(store.child.size());
+	}
+
+	// ids of each cascade form one ascending range, so the occurrences stay
+	// in ascending order of cascade
+	store.occurrence_begin = index.occurrence_begin;
+	store.occurrence_id.resize(num_slots);
+	for (int o = 0; o < num_slots; o++) {
+		store.occurrence_id[o] = slot_id[index.occurrence_slot[o]];
+	}
+
+	return true;
+
+}
+
+
+
+
+/*
+Function: store_reachable_from
+Input: storage, int, set of ints, traversal scratch
+Output: int
+
+Description: Same as reachable_from, for cascade c of a storage backend: the
+number of nodes reachable from the seed set S in the cascade, where every
+seed counts as reaching itself even if it is not in the cascade. The
+scratch must have room for store.num_ids() stamps.
+*/
+template <class Store>
+int store_reachable_from(Store& store, int c, set<int>& S, TraversalScratch& scratch)
+{
+
+	int stamp = ++scratch.current;
+	int r = 0;
+
+	scratch.queue.clear();
+
+	for (int s : S) {
+
+		r++;
+
+		int id = store.find(c, s);
+
+		if (id != -1) {
+			scratch.stamp[id] = stamp;
+			scratch.queue.push_back(id);
+		}
+
+	}
+
+	for (int head = 0; head < (int)scratch.queue.size(); head++) {
+
+		int u = scratch.queue[head];
+
+		for (int v : store.neighbors(u)) {
+
+			if (scratch.stamp[v] != stamp) {
+				scratch.stamp[v] = stamp;
+				scratch.queue.push_back(v);
+				r++;
+			}
+
+		}
+
+	}
+
+	return r;
+
+}
+
+
+
+
+/*
+Function: store_reachable_from
+Input: tree store, int, set of ints, traversal scratch
+Output: int
+
+Description: Overload of store_reachable_from for the tree store. The seeds
+reach the union of their preorder intervals; the intervals of a forest are
+nested or disjoint, so after sorting the seeds, a seed inside the interval of
+an earlier seed adds nothing and every other seed adds its whole interval.
+*/
+int store_reachable_from(TreeStore& store, int c, set<int>& S, TraversalScratch& scratch)
+{
+
+	int r = 0;
+
+	scratch.queue.clear();
+
+	for (int s : S) {
+
+		int id = store.find(c, s);
+
+		// a seed outside the cascade reaches only itself
+		if (id == -1) {
+			r++;
+		}
+		else {
+			scratch.queue.push_back(id);
+		}
+
+	}
+
+	sort(scratch.queue.begin(), scratch.queue.end());
+
+	int covered_until = -1;
+	for (int id : scratch.queue) {
+		if (id >= covered_until) {
+			r += store.subtree_size[id];
+			covered_until = id + store.subtree_size[id];
+		}
+	}
+
+	return r;
+
+}
+
+
+
+
+/*
+Function: store_influence
+Input: storage, set of ints, traversal scratch
+Output: double
+
+Description: Same as calculate_influence, for a storage backend.
+*/
+template <class Store>
+double store_influence(Store& store, set<int>& S, TraversalScratch& scratch)
+{
+
+	long long total = 0;
+
+	for (int c = 0; c < store.num_cascades(); c++) {
+		total += store_reachable_from(store, c, S, scratch);
+	}
+
+	return (double)total / store.num_cascades();
+
+}
+
+
+
+
+/*
+Function: time_store
+Input: storage, vector of sets of ints, vector of doubles
+Output: double
+
+Description: Computes the influence of every seed set with store_influence
+into influences and returns the time it took in seconds.
+*/
+template <class Store>
+double time_store(Store& store, vector<set<int> >& seed_sets, vector<double>& influences)
+{
+
+	TraversalScratch scratch;
+	scratch.stamp.assign(store.num_ids(), 0);
+
+	auto start = chrono::high_resolution_clock::now();
+
+	influences.clear();
+	for (set<int>& S : seed_sets) {
+		influences.push_back(store_influence(store, S, scratch));
+	}
+
+	return chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+
+}
+
+
+
+
+/*
+Function: run_backend_benchmark
+Input: vector of maps, set of ints
+Output: none
+
+Description: Computes the influence of PARAM_BACKEND_QUERIES random seed sets of
+size PARAM_K with calculate_influence on the maps and with every storage
+backend, and prints the time and memory of each backend and whether its
+influences match.
+*/
+void run_backend_benchmark(vector<map<int, vector<int> > >& cascades, set<int>& V)
+{
+
+	cout << endl << "RUNNING STORAGE BACKEND BENCHMARK..." << endl;
+
+	// draw the seed sets
+	mt19937 rng(PARAM_RANDOM_SEED);
+	vector<int> nodes(V.begin(), V.end());
+	vector<set<int> > seed_sets(PARAM_BACKEND_QUERIES);
+	for (set<int>& S : seed_sets) {
+		while (S.size() < min((size_t)PARAM_K, nodes.size())) {
+			S.insert(nodes[uniform_int_distribution<int>(0, nodes.size() - 1)(rng)]);
+		}
+	}
+
+	// the maps, through the reference implementation
+	vector<double> expected;
+	auto start = chrono::high_resolution_clock::now();
+	for (set<int>& S : seed_sets) {
+		expected.push_back(calculate_influence(cascades, S));
+	}
+	double map_seconds = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+
+	size_t map_bytes = cascade_bytes(cascades);
+
+	auto report = [&](string name, double seconds, size_t bytes, vector<double>& influences) {
+
+		int mismatches = 0;
+		for (int i = 0; i < (int)influences.size(); i++) {
+			mismatches += influences[i] != expected[i];
+		}
+
+		cout << name << ": " << to_string(seconds) << " SECONDS, SPEEDUP " << to_string(map_seconds / seconds)
+			<< ", MEMORY " << to_string(bytes / 1048576.0) << " MB, MISMATCHES " << to_string(mismatches) << endl;
+
+	};
+
+	vector<double> influences = expected;
+	report("MAP (REFERENCE)", map_seconds, map_bytes, influences);
+
+	CascadeIndex index;
+	build_cascade_index(cascades, index);
+
+	CsrStore csr;
+	csr_store(index, csr);
+	report("CSR", time_store(csr, seed_sets, influences), csr.bytes(), influences);
+
+	CsrStore mapped;
+	if (write_csr_store(index, STORE_FILE) && map_csr_store(STORE_FILE, mapped)) {
+		report("MMAPPED CSR", time_store(mapped, seed_sets, influences), mapped.bytes(), influences);
+	}
+	else {
+		cout << "MMAPPED CSR: n/a (CANNOT WRITE " << STORE_FILE << ")" << endl;
+	}
+
+	CompressedStore compressed;
+	build_compressed_store(index, compressed);
+	report("COMPRESSED", time_store(compressed, seed_sets, influences), compressed.bytes(), influences);
+
+	TreeStore tree;
+	if (build_tree_store(index, tree)) {
+		report("TREE", time_store(tree, seed_sets, influences), tree.bytes(), influences);
+	}
+	else {
+		cout << "TREE: n/a (NOT ALL CASCADES ARE FORESTS)" << endl;
+	}
+
+}
+
+
+
+
+
+/*
+Function: generate_cascades
+Input: int, int, int, int, random number generator, vector of maps
+Output: none
+
+Description: Replaces the cascades with count random cascades over the nodes 1
+to num_nodes, each with between 1 and max_size nodes. The nodes of a cascade
+join one at a time, and each node after the first is infected by one (if
+kind is CORPUS_FORESTS) or by one or two uniformly random nodes that joined
+before it, so the cascade is acyclic. With kind CORPUS_CYCLIC, each node
+after the first also has an edge back to a node that joined before it with
+probability 1/3, which closes a cycle whenever that node reaches it.
+*/
+void generate_cascades(int count, int max_size, int num_nodes, int kind, mt19937& rng,
+	vector<map<int, vector<int> > >& cascades)
+{
+
+	cascades.assign(count, map<int, vector<int> >());
+
+	vector<int> labels(num_nodes);
+	for (int i = 0; i < num_nodes; i++) {
+		labels[i] = i + 1;
+	}
+
+	for (map<int, vector<int> >& A : cascades) {
+
+		int size = uniform_int_distribution<int>(1, min(max_size, num_nodes))(rng);
+
+		// pick the nodes of the cascade
+		for (int i = 0; i < size; i++) {
+			swap(labels[i], labels[uniform_int_distribution<int>(i, num_nodes - 1)(rng)]);
+		}
+
+		A[labels[0]];
+
+		for (int i = 1; i < size; i++) {
+
+			set<int> parents;
+			int num_parents = kind == CORPUS_FORESTS ? 1 : uniform_int_distribution<int>(1, 2)(rng);
+			while ((int)parents.size() < min(num_parents, i)) {
+				parents.insert(uniform_int_distribution<int>(0, i - 1)(rng));
+			}
+
+			for (int j : parents) {
+				A[labels[j]].push_back(labels[i]);
+			}
+
+			if (kind == CORPUS_CYCLIC && uniform_int_distribution<int>(0, 2)(rng) == 0) {
+				A[labels[i]].push_back(labels[uniform_int_distribution<int>(0, i - 1)(rng)]);
+			}
+
+		}
+
+	}
+
+}
+
+
+
+
+/*
+Function: store_greedy
+Input: storage, set of ints, int, set of ints
+Output: long long
+
+Description: reference_greedy on a storage backend: adds k nodes of V to S,
+each time the first node in ascending order with the largest increase in
+the total reach, and returns the total reach of S over all cascades.
+*/
+template <class Store>
+long long store_greedy(Store& store, set<int>& V, int k, set<int>& S)
+{
+
+	TraversalScratch scratch;
+	scratch.stamp.assign(store.num_ids(), 0);
+
+	long long total = 0;
+
+	for (int iter = 0; iter < k; iter++) {
+
+		long long best_total = -1;
+		int best = -1;
+
+		for (int u : V) {
+
+			if (S.count(u)) {
+				continue;
+			}
+
+			set<int> T = S;
+			T.insert(u);
+
+			long long total_T = 0;
+			for (int c = 0; c < store.num_cascades(); c++) {
+				total_T += store_reachable_from(store, c, T, scratch);
+			}
+
+			if (total_T > best_total) {
+				best_total = total_T;
+				best = u;
+			}
+
+		}
+
+		S.insert(best);
+		total = best_total;
+
+	}
+
+	return total;
+
+}
+
+
+
+
+/*
+Structure: ReachLabels
+Description: Interval labels that answer "does slot u reach slot v" within a
+			 cascade of a cascade index (GRAIL, Yildirim et al. 2010). Each
+			 of the PARAM_REACH_LABELS labels comes from a depth-first search
+			 of the cascade with its own child order: a slot's interval is
+			 [low, post], where post is the slot's rank in the post-order
+			 and low the smallest rank in its subtree. If u reaches v, every
+			 interval of v lies in the matching interval of u, so one
+			 interval that does not ends the query. In a forest the first
+			 interval alone is exact; in other acyclic cascades a contained
+			 interval leads to a search pruned by the labels. Cascades with
+			 cycles are not labeled and are searched directly.
+*/
+struct ReachLabels
+{
+
+	int num_labels = 0;
+
+	// cascade -> whether it is a forest, and whether it has no cycles
+	FlatFlags forest;
+	FlatFlags acyclic;
+
+	// slot * num_labels + label -> the slot's interval in that label
+	FlatInts low;
+	FlatInts post;
+
+};
+
+
+
+
+/*
+Function: reach_contains
+Input: reach labels, int, int
+Output: bool
+
+Description: Returns whether every interval of slot v lies in the matching
+interval of slot u, which holds whenever u reaches v.
+*/
+bool reach_contains(ReachLabels& labels, int u, int v)
+{
+
+	int L = labels.num_labels;
+
+	for (int i = 0; i < L; i++) {
+		if (labels.low[v * L + i] < labels.low[u * L + i] || labels.post[v * L + i] > labels.post[u * L + i]) {
+			return false;
+		}
+	}
+
+	return true;
+
+}
+
+
+
+
+/*
+Function: label_cascade
+Input: cascade index, int, reach labels, vector of ints, vector of ints
+Output: none
+
+Description: Computes the forest and acyclic flags of cascade c and, if it is
+acyclic, its intervals (see ReachLabels). The roots (slots without incoming
+edges) start the searches in slot order for the first label; every further
+label starts at a random child of each slot and at a random root, and odd
+labels go through them backwards, so the labels disagree where they can.
+stack and in_degree are scratch space. Touches only the cascade's slots, so
+cascades can be labeled in parallel.
+*/
+void label_cascade(CascadeIndex& index, int c, ReachLabels& labels, vector<int>& stack, vector<int>& in_degree)
+{
+
+	int first = index.cascade_begin[c];
+	int size = index.cascade_begin[c + 1] - first;
+	int L = labels.num_labels;
+
+	in_degree.assign(size, 0);
+	for (int e = index.edge_begin[first]; e < index.edge_begin[first + size]; e++) {
+		in_degree[index.edge_target[e] - first]++;
+	}
+
+	bool forest = true;
+	vector<int> roots;
+	for (int s = 0; s < size; s++) {
+		forest = forest && in_degree[s] <= 1;
+		if (in_degree[s] == 0) {
+			roots.push_back(first + s);
+		}
+	}
+
+	// Kahn's algorithm; the cascade has a cycle if some slot is never freed
+	stack = roots;
+	int freed = 0;
+	while (!stack.empty()) {
+		int u = stack.back();
+		stack.pop_back();
+		freed++;
+		for (int e = index.edge_begin[u]; e < index.edge_begin[u + 1]; e++) {
+			if (--in_degree[index.edge_target[e] - first] == 0) {
+				stack.push_back(index.edge_target[e]);
+			}
+		}
+	}
+
+	labels.forest[c] = forest && freed == size;
+	labels.acyclic[c] = freed == size;
+
+	if (!labels.acyclic[c] || roots.empty()) {
+		return;
+	}
+
+	for (int i = 0; i < L; i++) {
+
+		CounterRng rng(PARAM_RANDOM_SEED, c, i);
+		int direction = i % 2 == 0 ? 1 : -1;
+
+		// post is 0 until a slot is visited, and low is set when it finishes
+		for (int s = first; s < first + size; s++) {
+			labels.post[s * L + i] = 0;
+		}
+
+		// the stack holds (slot, number of children handed out so far)
+		int rank = 0;
+		int root_offset = i == 0 ? 0 : rng.below(roots.size());
+
+		for (int r = 0; r < (int)roots.size(); r++) {
+
+			int root = roots[(root_offset + direction * r + roots.size()) % roots.size()];
+
+			stack.clear();
+			stack.push_back(root);
+			stack.push_back(0);
+			labels.post[root * L + i] = -1;
+
+			while (!stack.empty()) {
+
+				int u = stack[stack.size() - 2];
+				int& handed = stack.back();
+				int degree = index.edge_begin[u + 1] - index.edge_begin[u];
+
+				if (handed < degree) {
+
+					// the first child of u in this label's order is picked by
+					// the slot's own draw
+					int offset = i == 0 ? 0 : CounterRng(PARAM_RANDOM_SEED, u, i).below(degree);
+					int v = index.edge_target[index.edge_begin[u] + (offset + direction * handed + degree) % degree];
+					handed++;
+
+					if (labels.post[v * L + i] == 0) {
+						labels.post[v * L + i] = -1;
+						stack.push_back(v);
+						stack.push_back(0);
+					}
+
+					continue;
+
+				}
+
+				// every child has finished (the cascade is acyclic)
+				int low = ++rank;
+				for (int e = index.edge_begin[u]; e < index.edge_begin[u + 1]; e++) {
+					low = min(low, labels.low[index.edge_target[e] * L + i]);
+				}
+				labels.low[u * L + i] = low;
+				labels.post[u * L + i] = rank;
+
+				stack.pop_back();
+				stack.pop_back();
+
+			}
+
+		}
+
+	}
+
+}
+
+
+
+
+/*
+Function: build_reach_labels
+Input: cascade index, reach labels
+Output: none
+
+Description: Labels every cascade of the index (see label_cascade) on the
+thread pool, with PARAM_REACH_LABELS intervals per slot.
+*/
+void build_reach_labels(CascadeIndex& index, ReachLabels& labels)
+{
+
+	int num_cascades = index.cascade_begin.size() - 1;
+	int num_slots = index.slot_node.size();
+
+	labels.num_labels = max(PARAM_REACH_LABELS, 1);
+	labels.forest.assign(num_cascades, 0);
+	labels.acyclic.assign(num_cascades, 0);
+	labels.low.assign((size_t)num_slots * labels.num_labels, 0);
+	labels.post.assign((size_t)num_slots * labels.num_labels, 0);
+
+	vector<vector<int> > stacks(thread_pool().size);
+	vector<vector<int> > in_degrees(thread_pool().size);
+
+	parallel_for(num_cascades, [&](int worker, int c) {
+		label_cascade(index, c, labels, stacks[worker], in_degrees[worker]);
+	});
+
+}
+
+
+
+
+/*
+Function: slot_reaches
+Input: cascade index, reach labels, int, int, traversal scratch
+Output: bool
+
+Description: Returns whether slot u reaches slot v, two slots of the same
+cascade. Most queries end at the labels: an interval of v outside that of u
+rules the pair out, and in a forest containment rules it in. Otherwise a
+depth-first search from u enters only the slots whose intervals contain v's.
+Cascades with cycles are searched without labels.
+*/
+bool slot_reaches(CascadeIndex& index, ReachLabels& labels, int u, int v, TraversalScratch& scratch)
+{
+
+	if (u == v) {
+		return true;
+	}
+
+	int c = index.slot_cascade[u];
+
+	if (labels.acyclic[c]) {
+		if (!reach_contains(labels, u, v)) {
+			return false;
+		}
+		if (labels.forest[c]) {
+			return true;
+		}
+	}
+
+	int stamp = ++scratch.current;
+
+	scratch.queue.clear();
+	scratch.queue.push_back(u);
+	scratch.stamp[u] = stamp;
+
+	while (!scratch.queue.empty()) {
+
+		int w = scratch.queue.back();
+		scratch.queue.pop_back();
+
+		for (int e = index.edge_begin[w]; e < index.edge_begin[w + 1]; e++) {
+
+			int x = index.edge_target[e];
+
+			if (x == v) {
+				return true;
+			}
+
+			if (scratch.stamp[x] != stamp && (!labels.acyclic[c] || reach_contains(labels, x, v))) {
+				scratch.stamp[x] = stamp;
+				scratch.queue.push_back(x);
+			}
+
+		}
+
+	}
+
+	return false;
+
+}
+
+
+
+
+/*
+Function: count_reaching_cascades
+Input: cascade index, reach labels, int, int, traversal scratch
+Output: int
+
+Description: Returns the number of cascades in which node u (a label) reaches
+node v: the cascades where both appear and slot_reaches holds, found by
+merging the two occurrence lists, which are in ascending order of cascade. A
+node reaches itself in every cascade.
+*/
+int count_reaching_cascades(CascadeIndex& index, ReachLabels& labels, int u, int v, TraversalScratch& scratch)
+{
+
+	int num_cascades = index.cascade_begin.size() - 1;
+
+	if (u == v) {
+		return num_cascades;
+	}
+
+	auto du = lower_bound(index.labels.begin(), index.labels.end(), u);
+	auto dv = lower_bound(index.labels.begin(), index.labels.end(), v);
+
+	if (du == index.labels.end() || *du != u || dv == index.labels.end() || *dv != v) {
+		return 0;
+	}
+
+	int a = du - index.labels.begin();
+	int b = dv - index.labels.begin();
+
+	int count = 0;
+	int i = index.occurrence_begin[a];
+	int j = index.occurrence_begin[b];
+
+	while (i < index.occurrence_begin[a + 1] && j < index.occurrence_begin[b + 1]) {
+
+		int su = index.occurrence_slot[i];
+		int sv = index.occurrence_slot[j];
+		int cu = index.slot_cascade[su];
+		int cv = index.slot_cascade[sv];
+
+		if (cu < cv) {
+			i++;
+		}
+		else if (cv < cu) {
+			j++;
+		}
+		else {
+			count += slot_reaches(index, labels, su, sv, scratch);
+			i++;
+			j++;
+		}
+
+	}
+
+	return count;
+
+}
+
+
+
+
+/*
+Function: verify_engines
+Input: string, vector of maps, set of ints
+Output: int
+
+Description: Runs every exact engine on the cascades with seed sets of size
+PARAM_VERIFY_K (at most the number of nodes) and compares the selected set
+and its influence with those of reference_greedy, then checks the
+reachability labels against breadth-first search. Prints one line per
+engine and returns the number of engines that disagree.
+*/
+int verify_engines(string name, vector<map<int, vector<int> > >& cascades, set<int>& V)
+{
+
+	int k = min((int)V.size(), PARAM_VERIFY_K);
+	int num_cascades = cascades.size();
+
+	cout << endl << name << " (" << to_string(num_cascades) << " CASCADES, " << to_string(V.size())
+		<< " NODES, SETS OF SIZE " << to_string(k) << "):" << endl;
+
+	// the reference must only read the cascades the engines are checked on
+	vector<map<int, vector<int> > > original = cascades;
+
+	set<int> expected;
+	double expected_influence = reference_greedy(cascades, V, k, expected);
+
+	cout << "REFERENCE: ";
+	print_set(expected);
+	cout << " " << to_string(expected_influence) << endl;
+
+	int failures = 0;
+
+	bool unchanged = cascades == original;
+	failures += !unchanged;
+	cout << (unchanged ? "OK       " : "MISMATCH ") << "CASCADES UNCHANGED BY REFERENCE" << endl;
+	vector<map<int, vector<int> > >().swap(original);
+
+	auto check = [&](string engine, set<int>& S, double influence) {
+
+		bool same = S == expected && influence == expected_influence;
+		failures += !same;
+
+		cout << (same ? "OK       " : "MISMATCH ") << engine;
+		if (!same) {
+			cout << ": ";
+			print_set(S);
+			cout << " " << to_string(influence);
+		}
+		cout << endl;
+
+	};
+
+	for (int local = 0; local < 2; local++) {
+		set<int> S;
+		LazyStats stats;
+		long long total = lazy_greedy(cascades, k, local == 1, S, stats);
+		check(local == 1 ? "LAZY, SHARDED, LOCAL PLACEMENT" : "LAZY, SHARDED, INTERLEAVED PLACEMENT", S, (double)total / num_cascades);
+	}
+
+	if (PARAM_RACE_EXACT) {
+		set<int> S;
+		long long total = racing_greedy(cascades, k, S, false);
+		check("RACING", S, (double)total / num_cascades);
+	}
+
+	{
+		set<int> S;
+		long long total = screening_greedy(cascades, k, S, false);
+		check("SCREENING", S, (double)total / num_cascades);
+	}
+
+	{
+		set<int> S;
+		long long total = bitset_greedy(cascades, k, S);
+		check("BITSET", S, (double)total / num_cascades);
+	}
+
+	CascadeIndex index;
+	build_cascade_index(cascades, index);
+
+	{
+		vector<double> weights(num_cascades, 1.0);
+		vector<int> order;
+		weighted_greedy(index, weights, k, order);
+
+		set<int> S;
+		for (int d : order) {
+			S.insert(index.labels[d]);
+		}
+		check("WEIGHTED, UNIT WEIGHTS", S, weighted_influence(index, weights, order));
+	}
+
+	{
+		CsrStore store;
+		csr_store(index, store);
+		set<int> S;
+		long long total = store_greedy(store, V, k, S);
+		check("CSR STORE", S, (double)total / num_cascades);
+	}
+
+	{
+		CsrStore store;
+		if (write_csr_store(index, STORE_FILE) && map_csr_store(STORE_FILE, store)) {
+			set<int> S;
+			long long total = store_greedy(store, V, k, S);
+			check("MMAPPED CSR STORE", S, (double)total / num_cascades);
+
+			// the coverage-based engine runs on the mapped file directly
+			vector<double> weights(num_cascades, 1.0);
+			vector<int> order;
+			weighted_greedy(store, weights, k, order);
+			set<int> T;
+			for (int d : order) {
+				T.insert(store.labels[d]);
+			}
+			check("WEIGHTED, MMAPPED CSR STORE", T, weighted_influence(store, weights, order));
+		}
+	}
+
+	{
+		CompressedStore store;
+		build_compressed_store(index, store);
+		set<int> S;
+		long long total = store_greedy(store, V, k, S);
+		check("COMPRESSED STORE", S, (double)total / num_cascades);
+	}
+
+	{
+		TreeStore store;
+		if (build_tree_store(index, store)) {
+			set<int> S;
+			long long total = store_greedy(store, V, k, S);
+			check("TREE STORE", S, (double)total / num_cascades);
+		}
+	}
+
+	// the reachability labels must agree with a search from every slot, in
+	// every cascade of at most 256 slots
+	{
+		ReachLabels labels;
+		build_reach_labels(index, labels);
+
+		TraversalScratch reached;
+		TraversalScratch search;
+		prepare_scratch(index, reached);
+		prepare_scratch(index, search);
+
+		vector<int> reach;
+		bool same = true;
+		for (int c = 0; c < num_cascades; c++) {
+
+			if (index.cascade_begin[c + 1] - index.cascade_begin[c] > 256) {
+				continue;
+			}
+
+			for (int u = index.cascade_begin[c]; u < index.cascade_begin[c + 1]; u++) {
+				collect_reach(index, u, reached, reach);
+				for (int v = index.cascade_begin[c]; v < index.cascade_begin[c + 1]; v++) {
+					same = same && slot_reaches(index, labels, u, v, search) == (reached.stamp[v] == reached.current);
+				}
+			}
+
+		}
+
+		failures += !same;
+		cout << (same ? "OK       " : "MISMATCH ") << "REACHABILITY LABELS" << endl;
+	}
+
+	return failures;
+
+}
+
+
+
+
+/*
+Function: run_verify
+Input: vector of maps, set of ints
+Output: int
+
+Description: Differential check of all exact engines against
+reference_greedy, on the loaded cascades and on PARAM_VERIFY_CORPORA random
+corpora (forests, general acyclic cascades and cascades with cycles in
+turn, of growing size). Returns 0 if every engine agrees on every corpus and 1 otherwise,
+so that the program's exit status can gate a build.
+*/
+int run_verify(vector<map<int, vector<int> > >& cascades, set<int>& V)
+{
+
+	cout << endl << "VERIFYING ENGINES AGAINST THE REFERENCE GREEDY ALGORITHM..." << endl;
+
+	int failures = verify_engines("LOADED CASCADES", cascades, V);
+
+	mt19937 rng(PARAM_RANDOM_SEED);
+
+	for (int i = 0; i < PARAM_VERIFY_CORPORA; i++) {
+
+		int kind = i % 3;
+		int count = uniform_int_distribution<int>(1, 20 * (i + 1))(rng);
+		int max_size = uniform_int_distribution<int>(1, 30)(rng);
+		int num_nodes = uniform_int_distribution<int>(1, 10 + 5 * i)(rng);
+
+		vector<map<int, vector<int> > > generated;
+		generate_cascades(count, max_size, num_nodes, kind, rng, generated);
+
+		set<int> nodes;
+		for (map<int, vector<int> >& A : generated) {
+			for (auto& entry : A) {
+				nodes.insert(entry.first);
+				nodes.insert(entry.second.begin(), entry.second.end());
+			}
+		}
+
+		string kind_name = kind == CORPUS_FORESTS ? " (FORESTS)" : (kind == CORPUS_ACYCLIC ? " (ACYCLIC)" : " (CYCLIC)");
+		failures += verify_engines("RANDOM CORPUS " + to_string(i + 1) + kind_name, generated, nodes);
+
+	}
+
+	cout << endl << (failures == 0 ? "VERIFICATION PASSED" : "VERIFICATION FAILED: " + to_string(failures) + " MISMATCHES") << endl << endl;
+
+	return failures == 0 ? 0 : 1;
+
+}
+
+
+
+
+
+/*
+Function: write_cascade_files
+Input: string, vector of maps
+Output: none
+
+Description: Writes each cascade to the directory (created if needed) as an
+edgelist file named cascade_i.txt, in the format the program reads. A
+cascade without edges is written as a comment line.
+*/
+void write_cascade_files(string directory, vector<map<int, vector<int> > >& cascades)
+{
+
+	filesystem::create_directories(directory);
+
+	for (int c = 0; c < (int)cascades.size(); c++) {
+
+		ofstream outfile((filesystem::path(directory) / ("cascade_" + to_string(c) + ".txt")).string().c_str());
+
+		bool empty = true;
+		for (auto& entry : cascades[c]) {
+			for (int to : entry.second) {
+				outfile << entry.first << " " << to << "\n";
+				empty = false;
+			}
+		}
+
+		if (empty) {
+			outfile << POUND << " cascade without edges\n";
+		}
+
+	}
+
+}
+
+
+
+
+/*
+Function: resident_bytes
+Input: none
+Output: size_t
+
+Description: Returns the memory the program currently has resident, as given
+by /proc/self/statm, or 0 if it is not available.
+*/
+size_t resident_bytes()
+{
+
+	ifstream infile("/proc/self/statm");
+
+	size_t pages = 0;
+	size_t resident = 0;
+	infile >> pages >> resident;
+
+	return resident * sysconf(_SC_PAGESIZE);
+
+}
+
+
+
+
+/*
+Function: run_scaling
+Input: none
+Output: none
+
+Description: Scaling study of the load phase (reading the cascade files with
+get_cascade_vector) and the greedy phase (lazy_greedy) on generated
+cascades, with 1, 2, 4, ... threads up to PARAM_SCALING_MAX_THREADS. Strong
+scaling keeps the corpus fixed, at PARAM_SCALING_CASCADES cascades times 1,
+4, 16, ... (PARAM_SCALING_SIZES sizes). Weak scaling grows the corpus with
+the threads, PARAM_SCALING_CASCADES per thread. Each configuration is the
+fastest of PARAM_BENCHMARK_REPEATS runs. Writes one CSV row per
+configuration to SCALING_FILE (and the console) with the times, the
+throughput, the parallel efficiency (for strong scaling the time on one
+thread over threads times the time, for weak scaling the time on one thread
+with the smallest corpus over the time) and the memory of the maps, the
+shards of the lazy greedy, and the whole program after loading.
+*/
+void run_scaling()
+{
+
+	int max_threads = PARAM_SCALING_MAX_THREADS > 0 ? PARAM_SCALING_MAX_THREADS : max(1u, thread::hardware_concurrency());
+
+	vector<int> thread_counts;
+	for (int threads = 1; threads < max_threads; threads *= 2) {
+		thread_counts.push_back(threads);
+	}
+	thread_counts.push_back(max_threads);
+
+	cout << endl << "RUNNING SCALING STUDY ON UP TO " << to_string(max_threads) << " THREADS..." << endl << endl;
+
+	ofstream csv(SCALING_FILE.c_str());
+
+	string header = "study,threads,cascades,slots,load_seconds,greedy_seconds,load_cascades_per_second,"
+		"greedy_slots_per_second,load_efficiency,greedy_efficiency,cascade_mb,shard_mb,resident_mb";
+	csv << header << "\n";
+	cout << header << endl;
+
+	// generates the corpus of the given number of cascades once and returns
+	// its directory
+	map<int, string> corpora;
+	auto corpus = [&](int count) {
+
+		if (!corpora.count(count)) {
+
+			mt19937 rng(PARAM_RANDOM_SEED + count);
+			vector<map<int, vector<int> > > generated;
+			generate_cascades(count, PARAM_SCALING_MAX_SIZE, max(100, count), CORPUS_ACYCLIC, rng, generated);
+
+			corpora[count] = (filesystem::path(SCALING_DIRECTORY) / ("cascades_" + to_string(count))).string();
+			write_cascade_files(corpora[count], generated);
+
+		}
+
+		return corpora[count];
+
+	};
+
+	// runs one configuration and returns its load and greedy times
+	auto measure = [&](string study, int threads, int count, double load_base, double greedy_base, double scale) {
+
+		string directory = corpus(count);
+
+		thread_pool().resize(threads);
+
+		double load_seconds = 0;
+		double greedy_seconds = 0;
+		size_t map_bytes = 0;
+		size_t resident = 0;
+		LazyStats best;
+
+		for (int repeat = 0; repeat < PARAM_BENCHMARK_REPEATS; repeat++) {
+
+			set<int> V;
+			vector<map<int, vector<int> > > cascades;
+			vector<string> names;
+
+			auto start = chrono::high_resolution_clock::now();
+			get_cascade_vector(V, cascades, names, directory);
+			double load = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+
+			map_bytes = cascade_bytes(cascades);
+			resident = resident_bytes();
+
+			set<int> S;
+			LazyStats stats;
+			lazy_greedy(cascades, PARAM_K, PARAM_NUMA_LOCAL, S, stats);
+
+			if (repeat == 0 || load < load_seconds) {
+				load_seconds = load;
+			}
+			if (repeat == 0 || stats.greedy_seconds < greedy_seconds) {
+				greedy_seconds = stats.greedy_seconds;
+			}
+			best = stats;
+
+		}
+
+		// a configuration compared with itself has efficiency 1
+		if (load_base == 0) {
+			load_base = load_seconds;
+			greedy_base = greedy_seconds;
+		}
+
+		string row = study + "," + to_string(threads) + "," + to_string(count) + "," + to_string(best.num_slots) + ","
+			+ to_string(load_seconds) + "," + to_string(greedy_seconds) + ","
+			+ to_string(count / load_seconds) + "," + to_string(best.num_slots / greedy_seconds) + ","
+			+ to_string(load_base / (scale * load_seconds)) + "," + to_string(greedy_base / (scale * greedy_seconds)) + ","
+			+ to_string(map_bytes / 1048576.0) + "," + to_string(best.shard_bytes / 1048576.0) + ","
+			+ to_string(resident / 1048576.0);
+
+		csv << row << "\n";
+		cout << row << endl;
+
+		return make_pair(load_seconds, greedy_seconds);
+
+	};
+
+	// strong scaling: fixed corpora, more threads
+	int count = PARAM_SCALING_CASCADES;
+	for (int size = 0; size < PARAM_SCALING_SIZES; size++, count *= 4) {
+
+		pair<double, double> base(0, 0);
+
+		for (int threads : thread_counts) {
+			pair<double, double> times = measure("strong", threads, count, base.first, base.second, threads);
+			if (threads == 1) {
+				base = times;
+			}
+		}
+
+	}
+
+	// weak scaling: the corpus grows with the threads
+	pair<double, double> base(0, 0);
+	for (int threads : thread_counts) {
+		pair<double, double> times = measure("weak", threads, PARAM_SCALING_CASCADES * threads, base.first, base.second, 1);
+		if (threads == 1) {
+			base = times;
+		}
+	}
+
+	thread_pool().resize(num_threads());
+
+	cout << endl << "SCALING RESULTS WRITTEN TO " << SCALING_FILE << endl << endl;
+
+}
+
+
+
+
+
+/*
+Structure: RobustState
+Description: State of the robust greedy algorithm of MODE_ROBUST over several
+			 corpora loaded into one cascade index (so all corpora share one
+			 table of dense node ids). Since every slot belongs to one
+			 cascade and every cascade to one corpus, a single coverage array
+			 holds the coverage of every corpus.
+*/
+struct RobustState
+{
+
+	// slot -> whether a seed reaches it
+	FlatFlags covered;
+
+	// dense node id -> whether it is a seed
+	vector<char> chosen;
+
+	// corpus -> sum over its cascades of the nodes the seeds reach
+	vector<long long> reach;
+
+	// dense node ids of the seeds, in the order they were chosen
+	vector<int> seeds;
+
+};
+
+
+
+
+/*
+Function: reset_robust_state
+Input: cascade index, int, robust state
+Output: none
+
+Description: Empties the seed set of the robust state for the given number of
+corpora.
+*/
+void reset_robust_state(CascadeIndex& index, int num_corpora, RobustState& state)
+{
+
+	state.covered.assign(index.slot_node.size(), 0);
+	state.chosen.assign(index.labels.size(), 0);
+	state.reach.assign(num_corpora, 0);
+	state.seeds.clear();
+
+}
+
+
+
+
+/*
+Function: robust_gains
+Input: cascade index, vector of ints, vector of ints, vector of chars, int,
+	   traversal scratch, vector of long longs
+Output: none
+
+Description: Computes the marginal gain of node d in every corpus at once
+(corpus_of gives the corpus of each cascade, corpus_size the number of
+cascades of each corpus), with one search per occurrence of the node.
+*/
+void robust_gains(CascadeIndex& index, vector<int>& corpus_of, vector<int>& corpus_size, FlatFlags& covered, int d,
+	TraversalScratch& scratch, vector<long long>& gains)
+{
+
+	// a node reaches itself in every cascade it does not appear in
+	gains.assign(corpus_size.begin(), corpus_size.end());
+
+	for (int o = index.occurrence_begin[d]; o < index.occurrence_begin[d + 1]; o++) {
+
+		int slot = index.occurrence_slot[o];
+		int j = corpus_of[index.slot_cascade[slot]];
+
+		gains[j]--;
 
+		if (!covered[slot]) {
+			gains[j] += count_uncovered_reach(index, covered, slot, scratch);
+		}
+
+	}
+
+}
 
 
 
 
 /*
-Function: print_set
-Input: Set of integers
-Output: None
+Function: truncated_gain
+Input: vector of long longs, vector of long longs, vector of ints, double
+Output: double
 
-Description: Helper function that prints a set of integers to the console.
+Description: Returns the increase of the sum over the corpora of the
+influence in the corpus, truncated at level, when the reach of every corpus
+grows by the given gains.
 */
-void print_set(set<int>& S)
+double truncated_gain(vector<long long>& reach, vector<long long>& gains, vector<int>& corpus_size, double level)
 {
 
-	cout << "{";
+	double gain = 0;
 
-	int count = 0;
+	for (int j = 0; j < (int)reach.size(); j++) {
+		gain += min((double)(reach[j] + gains[j]) / corpus_size[j], level) - min((double)reach[j] / corpus_size[j], level);
+	}
 
-	for (int s : S) {
+	return gain;
 
-		cout << to_string(s);
+}
 
-		count++;
 
-		if (count < S.size()) {
-			cout << ", ";
-		}
 
+
+/*
+Function: robust_saturated
+Input: robust state, vector of ints, double
+Output: bool
+
+Description: Returns whether the influence of the seeds reaches level in
+every corpus.
+*/
+bool robust_saturated(RobustState& state, vector<int>& corpus_size, double level)
+{
+
+	for (int j = 0; j < (int)state.reach.size(); j++) {
+		if ((double)state.reach[j] / corpus_size[j] < level * (1 - 1e-12)) {
+			return false;
+		}
 	}
 
-	cout << "}";
+	return true;
 
 }
 
@@ -77,209 +8541,360 @@ void print_set(set<int>& S)
 
 
 /*
-Function: reachable_from
-Input: map from integers to vectors of integers, set of integers
+Function: truncated_greedy
+Input: cascade index, vector of ints, vector of ints, vector of long longs,
+	   double, int, bool, robust state, traversal scratch
 Output: none
 
-Description: Given a map that represents a cascade of influence through a network,
-			 finds the total number of nodes influenced by a seed set of nodes S 
-			 using breadth-first search.
+Description: Adds up to budget seeds to the robust state with the lazy greedy
+algorithm on the sum over the corpora of the influence truncated at level
+(submodular, like the influence itself), stopping early once every corpus
+reaches level if stop_when_saturated is set. singleton holds the gain of
+every node in every corpus for the empty set (node d, corpus j at
+d * number of corpora + j); since gains only shrink, the truncated gains they
+give are upper bounds for the queue. Ties go to the smaller node.
 */
-int reachable_from(map<int, vector<int> >& A, set<int>& S)
+void truncated_greedy(CascadeIndex& index, vector<int>& corpus_of, vector<int>& corpus_size, vector<long long>& singleton,
+	double level, int budget, bool stop_when_saturated, RobustState& state, TraversalScratch& scratch)
 {
 
-	// initialize count of nodes reachable from seed set S in cascade A
-	int r = 0;
+	int num_nodes = index.labels.size();
+	int num_corpora = corpus_size.size();
 
-	// initialize queue and map required to implement breadth-first search
-	queue<int> Q;
-	map<int, bool> explored;
+	// lazy queue of (upper bound on truncated gain, negated dense node id)
+	priority_queue<pair<double, int> > queue;
+	vector<double> bound(num_nodes);
+	vector<int> evaluated_at(num_nodes, -1);
+	vector<long long> gains(num_corpora);
 
-	// for each seed node in S, do:
-	for (int s : S) {
+	for (int d = 0; d < num_nodes; d++) {
+		if (!state.chosen[d]) {
+			gains.assign(singleton.begin() + (size_t)d * num_corpora, singleton.begin() + (size_t)(d + 1) * num_corpora);
+			bound[d] = truncated_gain(state.reach, gains, corpus_size, level);
+			queue.push(make_pair(bound[d], -d));
+		}
+	}
 
-		// increment reachable count by one, as seed nodes can always reach
-		// themselves
-		r++;
+	for (int added = 0; added < budget; added++) {
 
-		// add seed node to BFS queue
-		Q.push(s);
+		if (stop_when_saturated && robust_saturated(state, corpus_size, level)) {
+			return;
+		}
 
-		// mark each node in seed set explored
-		explored[s] = true;
-	}
+		int winner = -1;
 
-	// while the queue is not empty, do
-	while (!Q.empty()) {
+		while (!queue.empty()) {
 
-		// set u equal to the node at the front of the queue and pop the queue
-		int u = Q.front();
-		Q.pop();
+			int d = -queue.top().second;
+			double top = queue.top().first;
 
-		// for each node v reachable via an outgoing edge from u, do
-		for (int v : A[u]) {
+			if (state.chosen[d] || top != bound[d]) {
+				queue.pop();
+				continue;
+			}
 
-			// if v has not been explored, do
-			if (!explored[v]) {
+			if (evaluated_at[d] == added) {
+				winner = d;
+				break;
+			}
 
-				// add v to the queue
-				Q.push(v);
+			queue.pop();
+			robust_gains(index, corpus_of, corpus_size, state.covered, d, scratch, gains);
+			bound[d] = truncated_gain(state.reach, gains, corpus_size, level);
+			evaluated_at[d] = added;
+			queue.push(make_pair(bound[d], -d));
 
-				// mark v explored
-				explored[v] = true;
+		}
 
-				// increment the number of nodes reachable from the seed set by one
-				r++;
+		if (winner == -1 || bound[winner] <= 0) {
+			return;
+		}
 
-			}
+		queue.pop();
 
+		// add the winner and cover what it reaches in every corpus
+		state.chosen[winner] = 1;
+		state.seeds.push_back(winner);
+		for (int j = 0; j < num_corpora; j++) {
+			state.reach[j] += corpus_size[j];
+		}
+		for (int o = index.occurrence_begin[winner]; o < index.occurrence_begin[winner + 1]; o++) {
+			int slot = index.occurrence_slot[o];
+			int j = corpus_of[index.slot_cascade[slot]];
+			state.reach[j]--;
+			if (!state.covered[slot]) {
+				state.reach[j] += cover_reach(index, state.covered, slot, scratch);
+			}
 		}
 
 	}
 
-	// return number of nodes reachable in cascade A from seed set S
-	return r;
-
 }
 
 
 
 
-
 /*
-Function: calculate_influence
-Input: vector of maps, set of integers
-Output: double
+Function: print_robust_set
+Input: string, robust state, cascade index, vector of ints
+Output: none
 
-Description: Given a vector of maps representing information cascades. For each
-cascade, calculates the influence of a seed set of nodes S. Averages the numbers
-representing the influence of S under each cascade and returns this as the 
-overall influence of S.
+Description: Prints the seeds of the robust state, their influence in every
+corpus of ROBUST_DIRECTORIES, and the smallest of these influences.
 */
-double calculate_influence(vector<map<int, vector<int> > >& cascades, set<int>& S)
+void print_robust_set(string name, RobustState& state, CascadeIndex& index, vector<int>& corpus_size)
 {
 
-	// initialize double to store final influence value
-	double influence = 0.0;
-
-	// for each cascade in the cascade vector, do
-	for (map<int, vector<int> > A : cascades) {
-
-		// calculate the number of reachable nodes from S in the cascade A (i.e.,
-		// the influence of S in A)
-		int influence_A = reachable_from(A, S);
+	set<int> S;
+	for (int d : state.seeds) {
+		S.insert(index.labels[d]);
+	}
 
-		// add the influence of S in A to the total influence value
-		influence += influence_A;
+	cout << endl << name << " (SIZE " << to_string(S.size()) << "): ";
+	print_set(S);
+	cout << endl;
 
+	double worst = -1;
+	for (int j = 0; j < (int)corpus_size.size(); j++) {
+		double influence = (double)state.reach[j] / corpus_size[j];
+		cout << "INFLUENCE IN CORPUS " << to_string(j + 1) << " (" << ROBUST_DIRECTORIES[j] << "): " << to_string(influence) << endl;
+		worst = (worst == -1) ? influence : min(worst, influence);
 	}
 
-	// divide total influence value by number of cascades to obtain final
-	// influence value
-	influence = influence / cascades.size();
-
-	// return final influence value
-	return influence;
+	cout << "WORST-CASE INFLUENCE: " << to_string(worst) << endl;
 
 }
 
 
 
 
-
 /*
-Function: create_cascade
-Input: set of ints, map from ints to vectors of ints, string
+Function: run_robust_greedy
+Input: none
 Output: none
 
-Description: Given a set of ints representing all the nodes in all the cascades
-in the dataset, a map that will represent a single cascade as an adjacency list, 
-and a string representing a file name. Reads the edgelist specified in the 
-cascade .txt file and puts this information into the map. Also adds each node in 
-the cascade file to the set of all nodes in all the cascades.
+Description: Selects seeds that do well in every corpus of ROBUST_DIRECTORIES
+(maximizing the smallest influence over the corpora) with the SATURATE
+algorithm of Krause et al. (2008). All corpora are loaded into one cascade
+index, so they share one table of node ids and every evaluation of a node
+covers all corpora in one pass over its occurrences. A binary search over
+PARAM_ROBUST_STEPS steps looks for the highest level that the greedy
+algorithm on the truncated influence (see truncated_greedy) reaches in every
+corpus with PARAM_ROBUST_ALPHA * PARAM_K seeds. Seeds left over at that level
+are filled in by the greedy algorithm on the sum of the influences. For
+comparison, the set the greedy algorithm finds for the sum of the influences
+(the average case) is printed too.
 */
-void create_cascade(set<int>& V, map<int, vector<int> >& A, string graph_file_name)
+void run_robust_greedy()
 {
 
-	// initialize ifstream corresponding to the cascade file name
-	ifstream infile(graph_file_name.c_str());
+	auto start = chrono::high_resolution_clock::now();
+
+	cout << endl << "READING " << to_string(ROBUST_DIRECTORIES.size()) << " CORPORA..." << endl;
 
-	// while the .txt file still has lines, do
-	string line;
-	while(getline(infile, line))
-	{
+	set<int> V;
+	vector<map<int, vector<int> > > cascades;
+	vector<string> cascade_names;
+	vector<int> corpus_size;
+	vector<int> corpus_of;
 
-		// if the current line is not a comment line and is not empty
-		if (!(line.at(0) == POUND || line.at(0) == PERCENT) && !(line == "")) {
-			istringstream iss(line);
-			int from;
-			int to;
+	for (int j = 0; j < (int)ROBUST_DIRECTORIES.size(); j++) {
 
-			// read nodes in line
-			iss >> from >> to;
+		get_cascade_vector(V, cascades, cascade_names, ROBUST_DIRECTORIES[j]);
+		corpus_size.push_back(cascades.size() - corpus_of.size());
+		corpus_of.resize(cascades.size(), j);
 
-			// add nodes to map representing adjacency list
-			A[from].push_back(to);
+		cout << "CORPUS " << to_string(j + 1) << " (" << ROBUST_DIRECTORIES[j] << "): " << to_string(corpus_size[j])
+			<< " CASCADES" << endl;
 
-			// add nodes to set of all nodes in all the cascades
-			V.insert(to);
-			V.insert(from);
-			
+		if (corpus_size[j] == 0) {
+			cout << endl << "CORPUS " << to_string(j + 1) << " HAS NO CASCADES" << endl;
+			return;
 		}
 
 	}
 
-}
+	int num_corpora = corpus_size.size();
+	if (num_corpora == 0) {
+		return;
+	}
+
+	CascadeIndex index;
+	build_cascade_index(cascades, index);
+
+	int num_nodes = index.labels.size();
+	int budget = min(num_nodes, max(1, (int)ceil(PARAM_ROBUST_ALPHA * PARAM_K)));
+
+	// gains of every node in every corpus for the empty set, shared by all
+	// runs of truncated_greedy
+	vector<long long> singleton((size_t)num_nodes * num_corpora);
+	vector<TraversalScratch> scratch(thread_pool().size);
+	for (TraversalScratch& s : scratch) {
+		prepare_scratch(index, s);
+	}
+	FlatFlags none(index.slot_node.size(), 0);
+
+	parallel_for(num_nodes, [&](int worker, int d) {
+		vector<long long> gains;
+		robust_gains(index, corpus_of, corpus_size, none, d, scratch[worker], gains);
+		copy(gains.begin(), gains.end(), singleton.begin() + (size_t)d * num_corpora);
+	});
+
+	// no level above the sum of the budget largest singleton influences of a
+	// corpus can be reached in that corpus
+	double low = 0;
+	double high = -1;
+	for (int j = 0; j < num_corpora; j++) {
+		vector<long long> column(num_nodes);
+		for (int d = 0; d < num_nodes; d++) {
+			column[d] = singleton[(size_t)d * num_corpora + j];
+		}
+		nth_element(column.begin(), column.begin() + budget - 1, column.end(), greater<long long>());
+		long long sum = 0;
+		for (int i = 0; i < budget; i++) {
+			sum += column[i];
+		}
+		double reachable = (double)sum / corpus_size[j];
+		high = (high == -1) ? reachable : min(high, reachable);
+	}
 
+	cout << endl << "RUNNING ROBUST GREEDY ALGORITHM..." << endl;
+
+	RobustState best;
+	reset_robust_state(index, num_corpora, best);
+	RobustState state;
+
+	for (int step = 0; step < PARAM_ROBUST_STEPS; step++) {
+
+		double level = (low + high) / 2;
+
+		reset_robust_state(index, num_corpora, state);
+		truncated_greedy(index, corpus_of, corpus_size, singleton, level, budget, true, state, scratch[0]);
+
+		if (robust_saturated(state, corpus_size, level)) {
+			low = level;
+			best = state;
+		}
+		else {
+			high = level;
+		}
+
+	}
+
+	cout << endl << "LEVEL REACHED IN EVERY CORPUS: " << to_string(low) << endl;
+
+	// spend the seeds the level did not need on the average case
+	truncated_greedy(index, corpus_of, corpus_size, singleton, HUGE_VAL, budget - best.seeds.size(), false, best, scratch[0]);
+
+	RobustState average;
+	reset_robust_state(index, num_corpora, average);
+	truncated_greedy(index, corpus_of, corpus_size, singleton, HUGE_VAL, budget, false, average, scratch[0]);
+
+	cout << endl << "GREEDY ALGORITHM FINISHED!" << endl;
+
+	print_robust_set("ROBUST SET", best, index, corpus_size);
+	print_robust_set("AVERAGE-CASE SET", average, index, corpus_size);
+
+	auto stop = chrono::high_resolution_clock::now();
+
+	if (!PARAM_REPRODUCIBLE) {
+		cout << endl << "TIME (SEC): " << chrono::duration_cast<chrono::milliseconds>(stop - start).count() / 1000.0 << endl << endl;
+	}
+
+}
 
 
 
 
 /*
-Function: get_cascade_vector
-Input: set of ints, vector of maps
+Function: run_reachability
+Input: vector of maps
 Output: none
 
-Description: Given a set of ints representing all the nodes in all the cascades
-in the dataset and a vector of maps that will contain all of the cascades in
-the dataset. Collects the file names in the directory containing the cascade
-files. Reads the information in each cascade file into a map and adds this map 
-to the cascade vector.
+Description: Builds the reachability labels of every cascade (see ReachLabels)
+and answers the queries in QUERY_FILE on the thread pool. Each non-comment
+line holds two nodes u and v; the answer is the number of cascades in which u
+reaches v (see count_reaching_cascades). Prints the answers in the order of
+the queries, after the number of cascades whose queries the labels answer
+alone (forests), only prune (other acyclic cascades), or do not cover.
 */
-void get_cascade_vector(set<int>& V, vector<map<int, vector<int> > >& cascades)
+void run_reachability(vector<map<int, vector<int> > >& cascades)
 {
 
-	// initialize empty vector of strings to contain cascade file names
-	vector<string> graph_file_names;
+	CascadeIndex index;
+	build_cascade_index(cascades, index);
 
-	// for each file in the cascade directory specified by the user, do
-	for (auto file : filesystem::directory_iterator(CASCADE_DIRECTORY)) {
+	cout << endl << "BUILDING REACHABILITY LABELS..." << endl;
 
-		// get file path string
-		string file_path = file.path();
+	auto start = chrono::high_resolution_clock::now();
 
-		// if the file is a .txt file, add the file path to the vector of cascade
-		// file paths
-		if (file_path.find(".txt") != -1) {
-			graph_file_names.push_back(file_path);
+	ReachLabels labels;
+	build_reach_labels(index, labels);
+
+	auto built = chrono::high_resolution_clock::now();
+
+	int num_cascades = cascades.size();
+	int forests = 0;
+	int acyclic = 0;
+	for (int c = 0; c < num_cascades; c++) {
+		forests += labels.forest[c];
+		acyclic += labels.acyclic[c] && !labels.forest[c];
+	}
+
+	cout << endl << "CASCADES: " << to_string(forests) << " FORESTS (LABELS EXACT), " << to_string(acyclic)
+		<< " OTHER ACYCLIC (LABELS PRUNE SEARCHES), " << to_string(num_cascades - forests - acyclic)
+		<< " WITH CYCLES (SEARCHED)" << endl;
+	cout << "LABEL MEMORY (MB): " << to_string((double)sizeof(int) * (labels.low.size() + labels.post.size()) / (1 << 20)) << endl;
+	if (!PARAM_REPRODUCIBLE) {
+		cout << "LABELING TIME (SEC): " << to_string(chrono::duration<double>(built - start).count()) << endl;
+	}
+
+	// read the queries
+	vector<pair<int, int> > queries;
+
+	ifstream infile(QUERY_FILE.c_str());
+
+	string line;
+	while (getline(infile, line)) {
+
+		// skip empty and comment lines
+		if (line == "" || line.at(0) == POUND || line.at(0) == PERCENT) {
+			continue;
+		}
+
+		istringstream iss(line);
+
+		int u, v;
+		if (iss >> u >> v) {
+			queries.push_back(make_pair(u, v));
 		}
 
 	}
 
-	// for each file path in the vector of cascade file paths
-	for (string graph_file_name : graph_file_names) {
+	// answer them, each worker with its own scratch space
+	auto query_start = chrono::high_resolution_clock::now();
+
+	vector<int> answers(queries.size());
+	vector<TraversalScratch> scratch(thread_pool().size);
+	for (TraversalScratch& s : scratch) {
+		prepare_scratch(index, s);
+	}
 
-		// initalize a map that will represent the information in the cascade
-		// file as an adjacency list
-		map<int, vector<int> > A;
+	parallel_for(queries.size(), [&](int worker, int q) {
+		answers[q] = count_reaching_cascades(index, labels, queries[q].first, queries[q].second, scratch[worker]);
+	});
 
-		// populate the map with the information in the cascade file
-		// also add any new nodes in the current cascade to the set of all nodes in all the cascades
-		create_cascade(V, A, graph_file_name);
+	auto query_end = chrono::high_resolution_clock::now();
 
-		// add the map representing the cascade to the vector of cascades
-		cascades.push_back(A);
+	cout << endl << "REACHABILITY (CASCADES IN WHICH U REACHES V, OF " << to_string(num_cascades) << "):" << endl;
+	for (int q = 0; q < (int)queries.size(); q++) {
+		cout << to_string(queries[q].first) << " " << to_string(queries[q].second) << ": " << to_string(answers[q]) << endl;
+	}
 
+	if (!PARAM_REPRODUCIBLE) {
+		double seconds = chrono::duration<double>(query_end - query_start).count();
+		cout << endl << "QUERIES: " << to_string(queries.size()) << " IN " << to_string(seconds) << " SEC ("
+			<< to_string(seconds > 0 ? queries.size() / seconds : 0.0) << " PER SEC)" << endl;
 	}
 
 }
@@ -296,6 +8911,37 @@ Description: Main function that runs the program.
 */
 int main()
 {
+
+	// report the allocations of every mode when the program ends
+	if (PARAM_TRACK_ALLOCATIONS) {
+		atexit(print_allocations);
+	}
+
+	// in MODE_STREAMING, cascades are read one at a time from STREAM_PATH
+	// instead of from CASCADE_DIRECTORY
+	if (PARAM_MODE == MODE_STREAMING) {
+		run_streaming();
+		return 0;
+	}
+
+	// MODE_PREFETCH generates its own cascades
+	if (PARAM_MODE == MODE_PREFETCH) {
+		run_prefetch_benchmark();
+		return 0;
+	}
+
+	// MODE_SCALING generates its own cascades
+	if (PARAM_MODE == MODE_SCALING) {
+		run_scaling();
+		return 0;
+	}
+
+	// MODE_ROBUST reads its own corpora
+	if (PARAM_MODE == MODE_ROBUST) {
+		run_robust_greedy();
+		return 0;
+	}
+
 	// intialize a set to store all the nodes in all the cascades
 	set<int> V;
 
@@ -303,93 +8949,170 @@ int main()
 	// the cascades in the directory provided by the user
 	vector<map<int, vector<int> > > cascades;
 
+	// initialize a vector of strings to store the file path of each cascade
+	vector<string> cascade_names;
+
+	// initialize a vector of doubles to store the weight of each cascade (1
+	// unless its file gives one, as the files of a coreset do)
+	vector<double> cascade_weights;
+
+	// the cascade index and statistics built by the pipelined load
+	CascadeIndex loaded_index;
+	CascadeStats loaded_stats;
+
 	cout << endl << "READING CASCADES..." << endl;
 
 	// get the information in the cascade files and store it in the vector of 
 	// adjacency lists
-	// one adjacency list per cascade file
-	get_cascade_vector(V, cascades);
+	// one adjacency list per cascade file (or per cascade of the stream)
+	{
+		AllocationScope load_scope(allocation_tag("LOAD"));
+
+		if (PARAM_LOAD_STREAM) {
+			read_cascade_stream(V, cascades, cascade_names);
+		}
+		else if (PARAM_PIPELINED_LOAD) {
+			load_pipeline(V, cascades, cascade_names, loaded_index, loaded_stats, CASCADE_DIRECTORY, &cascade_weights);
+			pipelined_cascades = &cascades;
+			pipelined_index = &loaded_index;
+			pipelined_stats = &loaded_stats;
+		}
+		else {
+			get_cascade_vector(V, cascades, cascade_names, CASCADE_DIRECTORY, &cascade_weights);
+		}
+	}
 
 	cout << endl << "CASCADES READ! NUMBER OF CASCADES: " << to_string(cascades.size()) << endl;
 
-	cout << endl << "RUNNING GREEDY ALGORITHM..." << endl;
+	cascade_weights.resize(cascades.size(), 1.0);
 
-	auto start = chrono::high_resolution_clock::now();
+	// a weight line that does not parse would silently change the corpus
+	for (int c = 0; c < (int)cascades.size(); c++) {
+		if (cascade_weights[c] < 0) {
+			cout << endl << "ERROR: CASCADE FILE " << cascade_names[c] << " HAS AN INVALID WEIGHT" << endl;
+			return 1;
+		}
+	}
+	bool weighted = any_of(cascade_weights.begin(), cascade_weights.end(), [](double w) { return w != 1.0; });
 
-	// initialize a set to store the approximately optimal set of influencers
-	set<int> S;
+	// weighted cascades (a coreset) are run by the weighted greedy algorithm;
+	// the other modes count every cascade once
+	if (weighted && PARAM_MODE == MODE_GREEDY) {
+		run_weighted_greedy(cascades, cascade_weights);
+		return 0;
+	}
+	if (weighted) {
+		cout << endl << "WARNING: CASCADE WEIGHTS ARE IGNORED IN THIS MODE" << endl;
+	}
 
-	// initialize double to store the previous total influence of the set
-	double previous_influence = 0.0;
+	// in MODE_TOPICS, run one greedy per topic over the shared cascades instead
+	if (PARAM_MODE == MODE_TOPICS) {
+		run_topic_greedy(cascades, cascade_names);
+		return 0;
+	}
 
-	// for K iterations corresponding to the K nodes to be selected, do
-	for (int iter=0; iter<PARAM_K; iter++) {
+	// in MODE_SUBSAMPLE, evaluate candidates on adaptive samples of the cascades
+	if (PARAM_MODE == MODE_SUBSAMPLE) {
+		run_subsample_greedy(cascades);
+		return 0;
+	}
 
-		// initialize doubles and int to store the maximum change in the 
-		// objective function in this iteration, the maximum influence of a set
-		// in this iteration, and the node corresponding to the maximally influential
-		// node this iteration given the approximately optimal set so far
-		double max_delta = -1.0;
-		double max_influence = -1.0;
-		int max_delta_node = -1;
+	// in MODE_RACING, race the candidates of each iteration over blocks of cascades
+	if (PARAM_MODE == MODE_RACING) {
+		run_racing_greedy(cascades);
+		return 0;
+	}
 
-		// for each node u in all the cascades, do
-		for (int u : V) {
+	// in MODE_SCREENING, evaluate exactly only a shortlist ranked by sketches
+	if (PARAM_MODE == MODE_SCREENING) {
+		run_screening_greedy(cascades);
+		return 0;
+	}
 
-			// if u is not already in the approximately optimal set,
-			if (S.find(u) == S.end()) {
+	// in MODE_REACHABILITY, label the cascades and answer reachability queries
+	if (PARAM_MODE == MODE_REACHABILITY) {
+		run_reachability(cascades);
+		return 0;
+	}
 
-				// create a copy of the approximately optimal set and add u
-				set<int> T = S;
-				T.insert(u);
+	// in MODE_BITSET, count gains with precomputed reach bitsets
+	if (PARAM_MODE == MODE_BITSET) {
+		run_bitset_greedy(cascades);
+		return 0;
+	}
 
-				// calculate the influence of this new set
-				double influence_T = calculate_influence(cascades, T);
+	// in MODE_CORESET, write a weighted coreset of the cascades and check it
+	if (PARAM_MODE == MODE_CORESET) {
+		run_coreset(cascades, cascade_names);
+		return 0;
+	}
 
-				// calculate the change in the objective function when u is
-				// added to the approximately optimal set 
-				double delta = influence_T - previous_influence;
+	// in MODE_LAZY, run the lazy greedy algorithm on several threads
+	if (PARAM_MODE == MODE_LAZY) {
+		run_lazy_greedy(cascades, cascade_names);
+		return 0;
+	}
 
-				// if this change is larger than the maximum change this iteration,
-				// update the maximum change to be the change corresponding to u,
-				// update the maximum influence of a set this iteration to be the
-				// influence of the approximately optimal set plus u, and update
-				// the maximally influential node given the approximately
-				// optimal set this iteration to be u
-				if (delta > max_delta) {
-					max_delta = delta;
-					max_influence = influence_T;
-					max_delta_node = u;
-				}
+	// in MODE_BENCHMARK, compare the cascade placements of the lazy greedy
+	if (PARAM_MODE == MODE_BENCHMARK) {
+		run_benchmark(cascades);
+		return 0;
+	}
 
-			}
+	// in MODE_BACKENDS, compare the cascade storage backends
+	if (PARAM_MODE == MODE_BACKENDS) {
+		run_backend_benchmark(cascades, V);
+		return 0;
+	}
 
-		}
+	// in MODE_VERIFY, check every exact engine against the reference greedy
+	// algorithm; the exit status is nonzero if any of them disagrees
+	if (PARAM_MODE == MODE_VERIFY) {
+		return run_verify(cascades, V);
+	}
 
-		// add the maximally influential node to the approximately optimal set
-		S.insert(max_delta_node);
+	cout << endl << "RUNNING GREEDY ALGORITHM..." << endl;
 
-		// update the previous influence value to be the influence of this new set
-		previous_influence = max_influence;
+	auto start = chrono::high_resolution_clock::now();
 
-	}
+	// initialize a set to store the approximately optimal set of influencers
+	set<int> S;
+
+	// select the set and obtain its influence, and the runners-up of each
+	// iteration
+	vector<IterationRanking> rankings;
+	double influence = reference_greedy(cascades, V, PARAM_K, S, &rankings);
 
 	cout << endl << "GREEDY ALGORITHM FINISHED!" << endl;
 
+	print_rankings(rankings);
+
+	// write the influence of every prefix of the selection
+	if (!CURVE_FILE.empty()) {
+		write_curve(rankings);
+	}
+
 	// print the approximately optimal set
 	cout << endl << "APPROXIMATELY OPTIMAL SET (SIZE " << to_string(PARAM_K) << "): "; 
 	print_set(S);
 	cout << endl;
 	
 	// print the infleunce of the approximately optimal set
-	cout << endl << "INFLUENCE OF APPROX. OPTIMAL SET (NUMBER OF NODES): " << to_string(previous_influence) << endl;
+	cout << endl << "INFLUENCE OF APPROX. OPTIMAL SET (NUMBER OF NODES): " << to_string(influence) << endl;
 
 	auto stop = chrono::high_resolution_clock::now();
 
 	auto duration = chrono::duration_cast<chrono::milliseconds>(stop - start);
 
 	// print the total time the program took in seconds
-	cout << endl << "TIME (SEC): " << duration.count() / 1000.0 << endl << endl;
+	if (!PARAM_REPRODUCIBLE) {
+		cout << endl << "TIME (SEC): " << duration.count() / 1000.0 << endl << endl;
+	}
+
+	// explain which seed reached what in which cascade
+	if (!ATTRIBUTION_FILE.empty()) {
+		attribute_seeds(cascades, cascade_names, S);
+	}
 
 	return 0;
 }
\ No newline at end of file